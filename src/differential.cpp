@@ -0,0 +1,99 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "engine/tests/differential.hpp"
+
+/**
+ * Differential harness: runs random soups and well-known patterns through the reference node graph and every
+ * optimized engine, for every topology, both neighborhoods and many grid shapes, then reports per-engine speedups.
+ * Speedups are per world: the reference time is scaled by the worlds an engine steps at once (Engine::worlds()).
+ * Usage: differential [generations]. Exits with 1 on the first engine diverging from the reference.
+ */
+int main(int argc, char **argv) {
+    using namespace differential;
+    using std::chrono::duration;
+
+    Index generations = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 24;
+
+    std::vector<std::unique_ptr<Engine>> engines;
+    engines.push_back(std::make_unique<WorldEngine>("world", engine::WorldConfig{}));
+    engines.push_back(std::make_unique<WorldEngine>("world-tiled-3t", engine::WorldConfig{5, 3, 3}));
+    engines.push_back(std::make_unique<WorldEngine>("world-temporal-4", engine::WorldConfig{8, 8, 2, 4}));
+    engine::WorldConfig pyramid_config{6, 6, 1};
+    pyramid_config.pyramid_block = 3;
+    engines.push_back(std::make_unique<WorldEngine>("world-pyramid", pyramid_config));
+    engines.push_back(std::make_unique<EnsembleEngine>(3, 1));
+    engines.push_back(std::make_unique<EnsembleEngine>(70, 67));
+    engines.push_back(std::make_unique<BlockLutEngine>(1));
+    engines.push_back(std::make_unique<BlockLutEngine>(3));
+    engines.push_back(std::make_unique<StepperEngine>());
+
+    const std::vector<std::pair<Index, Index>> shapes{
+        {1, 1}, {1, 9}, {9, 1}, {2, 2}, {3, 3}, {5, 4}, {4, 5}, {8, 8}, {13, 7}, {17, 31}, {33, 33}, {64, 3}, {48, 40}
+    };
+
+    std::map<std::string, std::pair<duration<double>, duration<double>>> times;
+    Index scenarios = 0;
+    for (auto topology: {GridTopology::RAW, GridTopology::TORUS, GridTopology::REFLECT})
+        for (auto neighborhood: {GridNeighborhood::VON_NEUMANN, GridNeighborhood::MOORE})
+            for (auto [width, height]: shapes) {
+                auto cases = patterns(width, height, topology, neighborhood);
+                for (std::uint64_t seed = 1; seed != 4; ++ seed)
+                    cases.push_back(soup(width, height, topology, neighborhood, 0.15 * seed, seed));
+                for (auto &scenario: cases) {
+                    ++ scenarios;
+                    auto trajectory = trace(scenario, generations);
+                    for (auto &engine: engines) {
+                        auto outcome = compare(*engine, scenario, trajectory);
+                        times[engine->name()].first += trajectory.time * engine->worlds();
+                        times[engine->name()].second += outcome.time;
+                        if (!outcome.divergence)
+                            continue;
+
+                        auto divergence = *outcome.divergence;
+                        minimize(*engine, divergence);
+                        std::printf(
+                            "DIVERGED %s on %s %llux%llu %s %s\n",
+                            engine->name().c_str(), scenario.name.c_str(),
+                            static_cast<unsigned long long>(width), static_cast<unsigned long long>(height),
+                            topology == GridTopology::TORUS ? "torus"
+                                : topology == GridTopology::REFLECT ? "reflect" : "raw",
+                            neighborhood == GridNeighborhood::MOORE ? "moore" : "von-neumann"
+                        );
+                        std::printf(
+                            "  generation %llu, cell (%llu, %llu): expected %s\n",
+                            static_cast<unsigned long long>(divergence.generation),
+                            static_cast<unsigned long long>(divergence.i),
+                            static_cast<unsigned long long>(divergence.j),
+                            divergence.expected ? "alive" : "dead"
+                        );
+                        std::printf("  minimized initial generation:\n");
+                        auto &minimized = divergence.minimized;
+                        for (Index i = 0; i != minimized.height; ++ i) {
+                            std::printf("    ");
+                            for (Index j = 0; j != minimized.width; ++ j)
+                                std::printf("%c", minimized.alive(i, j) ? 'O' : '.');
+                            std::printf("\n");
+                        }
+                        return 1;
+                    }
+                }
+            }
+
+    std::printf(
+        "%llu scenarios x %llu generations match the reference\n",
+        static_cast<unsigned long long>(scenarios), static_cast<unsigned long long>(generations)
+    );
+    std::printf("%-20s %12s %12s %9s\n", "engine", "reference s", "engine s", "per world");
+    for (auto &[name, time]: times)
+        std::printf(
+            "%-20s %12.4f %12.4f %8.2fx\n",
+            name.c_str(), time.first.count(), time.second.count(), time.first.count() / time.second.count()
+        );
+    return 0;
+}
@@ -0,0 +1,283 @@
+#ifndef CPP_GAME_OF_DEATH_AUTOTUNE_HPP
+#define CPP_GAME_OF_DEATH_AUTOTUNE_HPP
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "block_lut.hpp"
+#include "world.hpp"
+
+namespace engine::errors {
+    struct AUTOTUNE_CACHE_WRITE : public std::runtime_error {
+        AUTOTUNE_CACHE_WRITE() : std::runtime_error("Autotune cache file can't be written") {};
+    };
+}
+
+namespace engine {
+
+    /// Stepping engines the autotuner chooses from.
+    enum class TunedEngine {
+        WORLD, ///< World with the tuned WorldConfig.
+        BLOCK_LUT ///< BlockLutWorld with the tuned number of threads; binary rules only.
+    };
+
+    /// Configuration picked for a machine and a shape class.
+    struct Tuning {
+        TunedEngine engine{TunedEngine::WORLD};
+        WorldConfig config; ///< Only `threads` applies to BLOCK_LUT.
+        double cell_ns{}; ///< Measured time per cell and generation.
+        bool measured{}; ///< Benchmarked by this call rather than read from the cache.
+    };
+
+    /**
+     * Picks the fastest stepping configuration for the machine it runs on.
+     *
+     * The first tune() of a machine and a shape class benchmarks every candidate (engine, tile size, threads,
+     * temporal depth) on a random soup for a share of the time budget, then stores the winner into a tab-separated
+     * cache file keyed by the CPU model and the shape class. Later calls, in this process or the next ones, read it.
+     * Shapes are classed by the powers of two their sides round up to, so similar worlds share a tuning.
+     */
+    class Autotuner {
+        std::filesystem::path cache_;
+        std::chrono::milliseconds budget_;
+        /// Tunings by cache key, see key().
+        std::map<std::string, Tuning> entries_;
+
+        static std::string to_string(GridNeighborhood neighborhood) {
+            return neighborhood == GridNeighborhood::MOORE ? "moore" : "von-neumann";
+        }
+
+        static std::string to_string(GridTopology topology) {
+            switch (topology) {
+                case GridTopology::TORUS:
+                    return "torus";
+                case GridTopology::REFLECT:
+                    return "reflect";
+                default:
+                    return "raw";
+            }
+        }
+
+        void load() {
+            std::ifstream file{cache_};
+            std::string line;
+            while (std::getline(file, line)) {
+                std::istringstream fields{line};
+                std::string key;
+                unsigned engine = 0;
+                Tuning tuning;
+                if (!std::getline(fields, key, '\t') ||
+                    !(fields >> engine >> tuning.config.tile_width >> tuning.config.tile_height >>
+                      tuning.config.threads >> tuning.config.temporal_depth >> tuning.cell_ns) ||
+                    engine > static_cast<unsigned>(TunedEngine::BLOCK_LUT) ||
+                    tuning.config.tile_width == 0 || tuning.config.tile_height == 0 || tuning.config.threads == 0)
+                    continue; // Malformed or from a newer version: tune again.
+                tuning.engine = static_cast<TunedEngine>(engine);
+                entries_[key] = tuning;
+            }
+        }
+
+        /// Rewrites the whole cache file through a temporary one, so concurrent readers never see half of it.
+        void save() const {
+            if (cache_.has_parent_path())
+                std::filesystem::create_directories(cache_.parent_path());
+            auto temporary = cache_;
+            temporary += ".tmp";
+            {
+                std::ofstream file{temporary, std::ios::trunc};
+                for (auto &[key, tuning]: entries_)
+                    file << key << '\t' << static_cast<unsigned>(tuning.engine) << ' '
+                         << tuning.config.tile_width << ' ' << tuning.config.tile_height << ' '
+                         << tuning.config.threads << ' ' << tuning.config.temporal_depth << ' '
+                         << tuning.cell_ns << '\n';
+                if (!file)
+                    throw errors::AUTOTUNE_CACHE_WRITE();
+            }
+            std::error_code error;
+            std::filesystem::rename(temporary, cache_, error);
+            if (error)
+                throw errors::AUTOTUNE_CACHE_WRITE();
+        }
+
+        /// Time per cell and generation of @param world, run @param batch generations at a time for about @param slice.
+        template<typename Engine>
+        static double measure(Engine &world, Index cells, Index batch, std::chrono::nanoseconds slice) {
+            using Clock = std::chrono::steady_clock;
+            world.run(batch);
+            Index generations = 0;
+            auto start = Clock::now();
+            auto elapsed = Clock::duration{};
+            do {
+                world.run(batch);
+                generations += batch;
+                elapsed = Clock::now() - start;
+            } while (elapsed < slice);
+            return std::chrono::duration<double, std::nano>(elapsed).count() / (generations * cells);
+        }
+
+        /// Time per cell and generation of @param tuning on a random soup, measured for about @param slice.
+        static double measure(
+                Index width,
+                Index height,
+                const TransitionTable &transitions,
+                GridTopology topology,
+                GridNeighborhood neighborhood,
+                const Tuning &tuning,
+                std::chrono::nanoseconds slice
+        ) {
+            const auto &config = tuning.config;
+            if (tuning.engine == TunedEngine::BLOCK_LUT) {
+                BlockLutWorld world{width, height, transitions, topology, neighborhood, config.threads};
+                world.randomize(0.3, 1);
+                return measure(world, width * height, 1, slice);
+            }
+            World world{width, height, transitions, topology, neighborhood, config};
+            world.randomize(BoundingBox{0, 0, height, width}, 0.3, 1);
+            return measure(world, width * height, config.temporal_depth, slice);
+        }
+
+    public:
+        /// Largest side of the world candidates are benchmarked on; bigger shapes are tuned on a cut.
+        static constexpr Index SAMPLE_SIDE = 1024;
+
+        /**
+         * @param cache file the tunings persist in, see default_cache()
+         * @param budget time spent benchmarking a shape class, split between the candidates
+         */
+        explicit Autotuner(
+                std::filesystem::path cache = default_cache(),
+                std::chrono::milliseconds budget = std::chrono::milliseconds{2000}
+        ) : cache_{std::move(cache)}, budget_{budget} {
+            load();
+        }
+
+        /// $XDG_CACHE_HOME/cpp_game_of_death/autotune.tsv, falling back to ~/.cache and the working directory.
+        static std::filesystem::path default_cache() {
+            std::filesystem::path root;
+            if (const char *xdg = std::getenv("XDG_CACHE_HOME"); xdg != nullptr && *xdg != '\0')
+                root = xdg;
+            else if (const char *home = std::getenv("HOME"); home != nullptr && *home != '\0')
+                root = std::filesystem::path{home} / ".cache";
+            return root / "cpp_game_of_death" / "autotune.tsv";
+        }
+
+        /// "model name" of /proc/cpuinfo and the number of hardware threads, e.g. "AMD EPYC 7B13 x64".
+        static std::string cpu_model() {
+            std::string model = "unknown";
+            std::ifstream cpuinfo{"/proc/cpuinfo"};
+            std::string line;
+            while (std::getline(cpuinfo, line))
+                if (line.starts_with("model name")) {
+                    auto colon = line.find(':');
+                    if (colon != std::string::npos && colon + 2 <= line.size())
+                        model = line.substr(colon + 2);
+                    break;
+                }
+            std::replace(model.begin(), model.end(), '\t', ' ');
+            return model + " x" + std::to_string(std::max(std::thread::hardware_concurrency(), 1u));
+        }
+
+        /**
+         * Shape class: sides rounded up to powers of two, topology (border handling changes the stepping cost),
+         * neighborhood and whether the rule is binary.
+         */
+        static std::string shape_class(Index width, Index height, const TransitionTable &transitions,
+                                       GridTopology topology, GridNeighborhood neighborhood) {
+            return std::to_string(std::bit_ceil(width)) + "x" + std::to_string(std::bit_ceil(height)) + " " +
+                   to_string(topology) + " " + to_string(neighborhood) +
+                   (transitions.is_binary() ? " binary" : " multistate");
+        }
+
+        /**
+         * Configurations benchmarked for a @param width x @param height world.
+         * @param binary whether the rule is binary, so BlockLutWorld can step it too
+         */
+        static std::vector<Tuning> candidates(Index width, Index height, bool binary = true) {
+            Index hardware = std::max(std::thread::hardware_concurrency(), 1u);
+            std::vector<Index> threads{1};
+            if (hardware >= 4)
+                threads.push_back(hardware / 2);
+            if (hardware >= 2)
+                threads.push_back(hardware);
+            // Full-width strips are capped at the height so that short worlds keep a candidate.
+            const std::pair<Index, Index> tiles[] = {
+                {64, 64}, {256, 32}, {1024, 16}, {width, std::min<Index>(8, height)}
+            };
+            std::vector<Tuning> result;
+            for (auto [tile_width, tile_height]: tiles) {
+                if (tile_width > width || tile_height > height)
+                    continue;
+                for (Index workers: threads)
+                    for (Index depth: {1, 4}) {
+                        Tuning tuning;
+                        tuning.config.tile_width = tile_width;
+                        tuning.config.tile_height = tile_height;
+                        tuning.config.threads = workers;
+                        tuning.config.temporal_depth = depth;
+                        result.push_back(tuning);
+                    }
+            }
+            if (binary)
+                for (Index workers: threads) {
+                    Tuning tuning;
+                    tuning.engine = TunedEngine::BLOCK_LUT;
+                    tuning.config.threads = workers;
+                    result.push_back(tuning);
+                }
+            return result;
+        }
+
+        /// Cache key of a shape class on this machine.
+        static std::string key(Index width, Index height, const TransitionTable &transitions,
+                               GridTopology topology, GridNeighborhood neighborhood) {
+            return cpu_model() + "|" + shape_class(width, height, transitions, topology, neighborhood);
+        }
+
+        /**
+         * Best configuration for stepping a world of this shape on this machine: read from the cache, otherwise
+         * benchmarked and persisted.
+         * @throw errors::AUTOTUNE_CACHE_WRITE if a new tuning can't be persisted
+         */
+        Tuning tune(
+                Index width,
+                Index height,
+                const TransitionTable &transitions = LifeRule::conway(),
+                GridTopology topology = GridTopology::TORUS,
+                GridNeighborhood neighborhood = GridNeighborhood::MOORE
+        ) {
+            auto entry = key(width, height, transitions, topology, neighborhood);
+            if (auto found = entries_.find(entry); found != entries_.end())
+                return found->second;
+
+            Index sample_width = std::min(width, SAMPLE_SIDE);
+            Index sample_height = std::min(height, SAMPLE_SIDE);
+            auto options = candidates(sample_width, sample_height, transitions.is_binary());
+            auto slice = std::chrono::duration_cast<std::chrono::nanoseconds>(budget_) / options.size();
+            Tuning best;
+            best.cell_ns = -1;
+            for (auto &option: options) {
+                option.cell_ns = measure(
+                    sample_width, sample_height, transitions, topology, neighborhood, option, slice
+                );
+                if (best.cell_ns < 0 || option.cell_ns < best.cell_ns)
+                    best = option;
+            }
+            entries_[entry] = best;
+            save();
+            best.measured = true;
+            return best;
+        }
+    };
+}
+
+#endif //CPP_GAME_OF_DEATH_AUTOTUNE_HPP
@@ -0,0 +1,343 @@
+#ifndef CPP_GAME_OF_DEATH_BLOCK_LUT_HPP
+#define CPP_GAME_OF_DEATH_BLOCK_LUT_HPP
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+#include "logger/metrics.hpp"
+#include "topology/conway_node.hpp"
+#include "cell_view.hpp"
+#include "random.hpp"
+#include "rule.hpp"
+#include "stencil.hpp"
+#include "thread_pool.hpp"
+
+namespace engine::errors {
+    struct BLOCK_LUT_OUT_OF_RANGE : public std::out_of_range {
+        BLOCK_LUT_OUT_OF_RANGE() : std::out_of_range("Block lookup world cell index is out of range") {};
+    };
+
+    struct BLOCK_LUT_BAD_CONFIG : public std::invalid_argument {
+        BLOCK_LUT_BAD_CONFIG() : std::invalid_argument(
+            "Block lookup world size must be positive and its transitions binary"
+        ) {};
+    };
+}
+
+namespace engine {
+    using conway::CellState;
+
+    /// Next 2 x 2 center (bit 2 r + c is cell (r + 1, c + 1)) of every 4 x 4 window (bit 4 r + c is cell (r, c)).
+    using BlockTable = std::array<std::uint8_t, 1 << 16>;
+
+    /**
+     * Block table of binary @param transitions over @param neighborhood. Tables are built once per rule and shared.
+     * @throw errors::BLOCK_LUT_BAD_CONFIG if @param transitions are not binary
+     */
+    inline std::shared_ptr<const BlockTable> block_table(
+            const TransitionTable &transitions,
+            GridNeighborhood neighborhood
+    ) {
+        if (!transitions.is_binary())
+            throw errors::BLOCK_LUT_BAD_CONFIG();
+        const auto offsets = stencil(neighborhood);
+        // The table only depends on the transitions of 0 to 8 neighbors.
+        std::uint32_t key = neighborhood == GridNeighborhood::MOORE;
+        for (std::uint8_t state = 0; state != 2; ++ state)
+            for (unsigned count = 0; count <= offsets.size(); ++ count)
+                key = key << 1 | transitions.next(state, count);
+
+        static std::mutex mutex;
+        static std::map<std::uint32_t, std::shared_ptr<const BlockTable>> tables;
+        std::lock_guard lock{mutex};
+        if (auto found = tables.find(key); found != tables.end())
+            return found->second;
+
+        auto table = std::make_shared<BlockTable>();
+        for (unsigned window = 0; window != table->size(); ++ window) {
+            auto cell = [window](int r, int c) { return (window >> (4 * r + c)) & 1u; };
+            std::uint8_t next = 0;
+            for (int r = 1; r != 3; ++ r)
+                for (int c = 1; c != 3; ++ c) {
+                    unsigned count = 0;
+                    for (auto offset: offsets)
+                        count += cell(r + offset.di, c + offset.dj);
+                    next |= (transitions.next(cell(r, c), count) & 1u) << (2 * (r - 1) + (c - 1));
+                }
+            (*table)[window] = next;
+        }
+        tables.emplace(key, table);
+        return table;
+    }
+
+    /**
+     * Binary engine stepping the world by 2 x 2 blocks through a table of every 4 x 4 window (see block_table()).
+     *
+     * Cells are bit-packed rows; a row is framed by a ghost word on the west (column -1 is its last bit) and one on
+     * the east, and the grid by ghost rows, filled from the topology before every step. For each block the 4 window
+     * rows give 4 bits each by shifts, so a whole generation costs one table lookup per 4 cells, for any binary rule
+     * without a rule-specific kernel. Odd sizes compute a phantom row or column in the ghost frame, which the next
+     * fill overwrites. Block rows are split between the threads.
+     */
+    class BlockLutWorld {
+        using Word = std::uint64_t;
+        static constexpr Index WORD_BITS = 64;
+
+        Index width_;
+        Index height_;
+        Index words_;
+        /// Words per buffer row: the cells and a ghost word on either side.
+        Index stride_;
+        /// Rows of 2 x 2 blocks.
+        Index block_rows_;
+        TransitionTable transitions_;
+        GridTopology topology_;
+        GridNeighborhood neighborhood_;
+        std::shared_ptr<const BlockTable> table_;
+
+        /// Rows -1 to the last block row + 1, so the windows of odd heights stay inside.
+        std::vector<Word> current_;
+        std::vector<Word> next_;
+
+        std::unique_ptr<ThreadPool> pool_;
+        std::vector<Index> slab_population_;
+        Index population_{};
+        Index generation_{};
+
+        Word *row(std::vector<Word> &buffer, long long i) {
+            return buffer.data() + (i + 1) * static_cast<long long>(stride_) + 1;
+        }
+
+        const Word *row(const std::vector<Word> &buffer, long long i) const {
+            return buffer.data() + (i + 1) * static_cast<long long>(stride_) + 1;
+        }
+
+        Word last_word_mask() const {
+            Index bits = width_ % WORD_BITS;
+            return bits == 0 ? ~Word{0} : (Word{1} << bits) - 1;
+        }
+
+        static bool bit(const Word *cells, long long j) {
+            return (cells[(j + WORD_BITS) / WORD_BITS - 1] >> ((j + WORD_BITS) % WORD_BITS)) & 1u;
+        }
+
+        static void set_bit(Word *cells, long long j, bool value) {
+            Word &word = cells[(j + WORD_BITS) / WORD_BITS - 1];
+            Word mask = Word{1} << ((j + WORD_BITS) % WORD_BITS);
+            word = value ? word | mask : word & ~mask;
+        }
+
+        /// Columns -1 and width() of every row, then rows -1 and height() whole, from the topology.
+        void fill_ghosts() {
+            auto west = neighbor_index(0, 0, {0, -1}, width_, 1, topology_);
+            auto east = neighbor_index(0, width_ - 1, {0, 1}, width_, 1, topology_);
+            for (Index i = 0; i != height_; ++ i) {
+                Word *cells = row(current_, i);
+                set_bit(cells, -1, west && bit(cells, *west));
+                set_bit(cells, static_cast<long long>(width_), east && bit(cells, *east));
+            }
+            auto above = neighbor_index(0, 0, {-1, 0}, 1, height_, topology_);
+            auto below = neighbor_index(height_ - 1, 0, {1, 0}, 1, height_, topology_);
+            Word *first = row(current_, -1) - 1;
+            Word *last = row(current_, static_cast<long long>(height_)) - 1;
+            if (above)
+                std::copy_n(row(current_, *above) - 1, stride_, first);
+            else
+                std::fill_n(first, stride_, 0);
+            if (below)
+                std::copy_n(row(current_, *below) - 1, stride_, last);
+            else
+                std::fill_n(last, stride_, 0);
+        }
+
+        /// 4 bits of the window of block @param t (columns 2 t - 1 to 2 t + 2 of word @param w) of @param cells.
+        struct Window {
+            Word low; ///< Columns 64 w - 1 to 64 w + 62 of the row.
+            Word tail; ///< Columns 64 w + 61 to 64 w + 64 in the 4 low bits, for the last block.
+
+            Window(const Word *cells, Index w) :
+                low{(cells[w] << 1) | (cells[w - 1] >> (WORD_BITS - 1))},
+                tail{(low >> 62) | ((cells[w] >> 63) << 2) | ((cells[w + 1] & 1u) << 3)} {}
+
+            unsigned operator [] (unsigned t) const {
+                return t == 31 ? static_cast<unsigned>(tail) : static_cast<unsigned>(low >> (2 * t)) & 0xfu;
+            }
+        };
+
+        /// Computes block rows [@param first, @param last). @return alive cells
+        Index step_block_rows(Index first, Index last) {
+            const BlockTable &table = *table_;
+            const Word mask = last_word_mask();
+            Index population = 0;
+            for (Index a = first; a != last; ++ a) {
+                const long long top = 2 * static_cast<long long>(a);
+                const Word *rows[4] = {
+                    row(current_, top - 1), row(current_, top), row(current_, top + 1), row(current_, top + 2)
+                };
+                Word *upper = row(next_, top);
+                Word *lower = row(next_, top + 1);
+                for (Index w = 0; w != words_; ++ w) {
+                    const Window windows[4] = {{rows[0], w}, {rows[1], w}, {rows[2], w}, {rows[3], w}};
+                    Word up = 0, down = 0;
+                    for (unsigned t = 0; t != WORD_BITS / 2; ++ t) {
+                        unsigned next = table[windows[0][t] | windows[1][t] << 4 | windows[2][t] << 8 |
+                                              windows[3][t] << 12];
+                        up |= Word{next & 3u} << (2 * t);
+                        down |= Word{next >> 2} << (2 * t);
+                    }
+                    if (w + 1 == words_) {
+                        up &= mask;
+                        down &= mask;
+                    }
+                    upper[w] = up;
+                    lower[w] = down;
+                    population += std::popcount(up);
+                    // The lower row of the last block row of an odd height is the phantom one.
+                    if (static_cast<Index>(top + 1) < height_)
+                        population += std::popcount(down);
+                }
+            }
+            return population;
+        }
+
+        void check(Index i, Index j) const {
+            if (i >= height_ || j >= width_)
+                throw errors::BLOCK_LUT_OUT_OF_RANGE();
+        }
+
+    public:
+        /**
+         * Creates an all-dead world.
+         * @param width world width
+         * @param height world height
+         * @param transitions binary rule, e.g. a LifeRule
+         * @param topology the way border cells are connected
+         * @param neighborhood same meaning as for make_grid()
+         * @param threads number of threads computing the block rows
+         * @throw errors::BLOCK_LUT_BAD_CONFIG on zero sizes or multi-state transitions
+         */
+        BlockLutWorld(
+                Index width,
+                Index height,
+                const TransitionTable &transitions = LifeRule::conway(),
+                GridTopology topology = GridTopology::RAW,
+                GridNeighborhood neighborhood = GridNeighborhood::VON_NEUMANN,
+                Index threads = 1
+        ) :
+            width_{width},
+            height_{height},
+            words_{(width + WORD_BITS - 1) / WORD_BITS},
+            stride_{words_ + 2},
+            block_rows_{(height + 1) / 2},
+            transitions_{transitions},
+            topology_{topology},
+            neighborhood_{neighborhood}
+        {
+            if (width == 0 || height == 0)
+                throw errors::BLOCK_LUT_BAD_CONFIG();
+            metrics::ScopedTimer timer{metrics::Phase::GRID_BUILD};
+            table_ = block_table(transitions, neighborhood);
+            current_.assign((2 * block_rows_ + 2) * stride_, 0);
+            next_.assign(current_.size(), 0);
+            pool_ = std::make_unique<ThreadPool>(std::clamp<Index>(threads, 1, block_rows_));
+            slab_population_.assign(pool_->size(), 0);
+        }
+
+        Index width() const { return width_; }
+
+        Index height() const { return height_; }
+
+        GridTopology topology() const { return topology_; }
+
+        GridNeighborhood neighborhood() const { return neighborhood_; }
+
+        const TransitionTable &transitions() const { return transitions_; }
+
+        /// Number of generations performed.
+        Index generation() const { return generation_; }
+
+        /// Alive cells of the current generation.
+        Index population() const { return population_; }
+
+        CellState get(Index i, Index j) const {
+            check(i, j);
+            return bit(row(current_, i), j) ? CellState::ALIVE : CellState::DEAD;
+        }
+
+        /// Sets a cell of the current generation. Keeps the population exact.
+        void set(Index i, Index j, CellState state) {
+            check(i, j);
+            Word *cells = row(current_, i);
+            bool alive = state == CellState::ALIVE;
+            if (bit(cells, j) == alive)
+                return;
+            set_bit(cells, j, alive);
+            population_ = alive ? population_ + 1 : population_ - 1;
+        }
+
+        /// Current generation in place, without the ghost frame. Valid until the next step.
+        PackedRowView view() const {
+            return PackedRowView{row(current_, 0), width_, height_, stride_};
+        }
+
+        /**
+         * Replaces every cell with the soup World::randomize() makes of the whole world for the same arguments.
+         * @throw errors::RANDOM_BAD_DENSITY if @param density is not within [0, 1]
+         */
+        void randomize(double density, std::uint64_t seed) {
+            const random::Density probability{density};
+            metrics::ScopedTimer timer{metrics::Phase::GRID_BUILD};
+            pool_->run(slab_population_.size(), [this, &probability, seed](Index slab, Index) {
+                Index population = 0;
+                for (Index i = height_ * slab / pool_->size(); i != height_ * (slab + 1) / pool_->size(); ++ i) {
+                    Word *cells = row(current_, i);
+                    std::fill_n(cells, words_, 0);
+                    for (Index j = 0; j != width_; ++ j)
+                        if (random::cell_alive(seed, j + i * width_, probability)) {
+                            cells[j / WORD_BITS] |= Word{1} << (j % WORD_BITS);
+                            ++ population;
+                        }
+                }
+                slab_population_[slab] = population;
+            });
+            population_ = 0;
+            for (Index population: slab_population_)
+                population_ += population;
+        }
+
+        /// Advances the world by one generation.
+        void step() {
+            fill_ghosts();
+            {
+                metrics::ScopedTimer timer{metrics::Phase::EXEC};
+                pool_->run(slab_population_.size(), [this](Index slab, Index) {
+                    slab_population_[slab] = step_block_rows(
+                        block_rows_ * slab / slab_population_.size(),
+                        block_rows_ * (slab + 1) / slab_population_.size()
+                    );
+                });
+            }
+            metrics::ScopedTimer timer{metrics::Phase::COMMIT};
+            current_.swap(next_);
+            population_ = 0;
+            for (Index population: slab_population_)
+                population_ += population;
+            ++ generation_;
+        }
+
+        /// Performs @param generations steps.
+        void run(Index generations) {
+            for (; generations != 0; -- generations)
+                step();
+        }
+    };
+}
+
+#endif //CPP_GAME_OF_DEATH_BLOCK_LUT_HPP
@@ -0,0 +1,40 @@
+#ifndef CPP_GAME_OF_DEATH_BOUNDING_BOX_HPP
+#define CPP_GAME_OF_DEATH_BOUNDING_BOX_HPP
+
+#include <algorithm>
+
+#include "topology/node_array.hpp"
+
+namespace engine {
+    using topology::Index;
+
+    /// Half-open rectangle of cells: rows [top, bottom), columns [left, right).
+    struct BoundingBox {
+        Index top{};
+        Index left{};
+        Index bottom{};
+        Index right{};
+
+        bool empty() const {
+            return top == bottom || left == right;
+        }
+
+        /// Grows the box so it also covers @param other.
+        void include(const BoundingBox &other) {
+            if (other.empty())
+                return;
+            if (empty()) {
+                *this = other;
+                return;
+            }
+            top = std::min(top, other.top);
+            left = std::min(left, other.left);
+            bottom = std::max(bottom, other.bottom);
+            right = std::max(right, other.right);
+        }
+
+        bool operator == (const BoundingBox &) const = default;
+    };
+}
+
+#endif //CPP_GAME_OF_DEATH_BOUNDING_BOX_HPP
@@ -0,0 +1,150 @@
+#ifndef CPP_GAME_OF_DEATH_BUFFER_HPP
+#define CPP_GAME_OF_DEATH_BUFFER_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <span>
+#include <utility>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+#include "topology/node_array.hpp"
+
+namespace engine {
+    using topology::Index;
+
+    /// Alignment of buffers and of row starts: a cache line, which also covers the widest SIMD loads.
+    constexpr Index CACHE_LINE = 64;
+
+    /// Size of the huge pages asked for with MAP_HUGETLB / MADV_HUGEPAGE.
+    constexpr Index HUGE_PAGE = 2 * 1024 * 1024;
+
+    /// Page kind a CellBuffer ended up with.
+    enum class PageKind {
+        REGULAR, ///< Aligned heap or mmap memory on base pages.
+        TRANSPARENT_HUGE, ///< Regular mapping advised with MADV_HUGEPAGE; the kernel may back it with huge pages.
+        HUGE ///< Explicit MAP_HUGETLB pages from the reserved pool.
+    };
+
+    /**
+     * Row stride for rows of @param width cells: rounded up to a cache line, so every row starts aligned, plus one
+     * more line when the stride is a multiple of 4 KiB, so vertically adjacent cells don't map to the same cache set.
+     */
+    constexpr Index row_stride(Index width) {
+        Index stride = (width + CACHE_LINE - 1) / CACHE_LINE * CACHE_LINE;
+        if (stride % 4096 == 0)
+            stride += CACHE_LINE;
+        return stride;
+    }
+
+    /**
+     * Owning byte buffer of cell states, aligned to CACHE_LINE.
+     *
+     * On request, buffers of at least HUGE_PAGE bytes are mapped on huge pages when the system has them reserved
+     * (MAP_HUGETLB), otherwise they are mapped normally and advised for transparent huge pages. Everything else comes
+     * from the aligned heap.
+     * Memory is not written at allocation, so its pages are placed on the NUMA node of the thread that writes them
+     * first. Heap memory is uninitialized, mapped memory reads as zero.
+     */
+    class CellBuffer {
+        std::uint8_t *data_{nullptr};
+        Index size_{};
+        Index mapped_{}; ///< Length of the mapping, 0 for heap memory.
+        PageKind pages_{PageKind::REGULAR};
+
+        void allocate(bool huge_pages) {
+#ifdef __linux__
+            if (huge_pages && size_ >= HUGE_PAGE) {
+                Index length = (size_ + HUGE_PAGE - 1) / HUGE_PAGE * HUGE_PAGE;
+                void *memory = mmap(nullptr, length, PROT_READ | PROT_WRITE,
+                                    MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+                if (memory != MAP_FAILED) {
+                    pages_ = PageKind::HUGE;
+                } else {
+                    memory = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+                    if (memory == MAP_FAILED)
+                        throw std::bad_alloc();
+                    if (madvise(memory, length, MADV_HUGEPAGE) == 0)
+                        pages_ = PageKind::TRANSPARENT_HUGE;
+                }
+                data_ = static_cast<std::uint8_t *>(memory);
+                mapped_ = length;
+                return;
+            }
+#else
+            (void) huge_pages;
+#endif
+            Index length = (size_ + CACHE_LINE - 1) / CACHE_LINE * CACHE_LINE;
+            data_ = static_cast<std::uint8_t *>(std::aligned_alloc(CACHE_LINE, std::max<Index>(length, CACHE_LINE)));
+            if (data_ == nullptr)
+                throw std::bad_alloc();
+        }
+
+        void release() {
+            if (data_ == nullptr)
+                return;
+#ifdef __linux__
+            if (mapped_ != 0) {
+                munmap(data_, mapped_);
+                return;
+            }
+#endif
+            std::free(data_);
+        }
+
+    public:
+        CellBuffer() = default;
+
+        /**
+         * @param size bytes
+         * @param huge_pages whether to try huge pages, see the class description
+         * @throw std::bad_alloc
+         */
+        explicit CellBuffer(Index size, bool huge_pages = false) : size_{size} {
+            allocate(huge_pages);
+        };
+
+        ~CellBuffer() {
+            release();
+        }
+
+        CellBuffer(const CellBuffer &) = delete;
+        CellBuffer &operator = (const CellBuffer &) = delete;
+
+        CellBuffer(CellBuffer &&other) noexcept {
+            swap(other);
+        }
+
+        CellBuffer &operator = (CellBuffer &&other) noexcept {
+            swap(other);
+            return *this;
+        }
+
+        std::uint8_t *data() { return data_; }
+
+        const std::uint8_t *data() const { return data_; }
+
+        Index size() const { return size_; }
+
+        PageKind pages() const { return pages_; }
+
+        std::uint8_t &operator [] (Index idx) { return data_[idx]; }
+
+        const std::uint8_t &operator [] (Index idx) const { return data_[idx]; }
+
+        std::span<const std::uint8_t> span() const { return {data_, size_}; }
+
+        void swap(CellBuffer &other) noexcept {
+            std::swap(data_, other.data_);
+            std::swap(size_, other.size_);
+            std::swap(mapped_, other.mapped_);
+            std::swap(pages_, other.pages_);
+        }
+    };
+}
+
+#endif //CPP_GAME_OF_DEATH_BUFFER_HPP
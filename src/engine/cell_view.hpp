@@ -0,0 +1,156 @@
+#ifndef CPP_GAME_OF_DEATH_CELL_VIEW_HPP
+#define CPP_GAME_OF_DEATH_CELL_VIEW_HPP
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <stdexcept>
+#include <version>
+
+#if defined(__cpp_lib_mdspan)
+#include <mdspan>
+#endif
+
+#include "topology/node_array.hpp"
+
+namespace engine::errors {
+    struct VIEW_EXPORT_TOO_SMALL : public std::length_error {
+        VIEW_EXPORT_TOO_SMALL() : std::length_error("Export destination is too small for the viewed cells") {};
+    };
+}
+
+namespace engine {
+    using topology::Index;
+
+#if defined(__cpp_lib_mdspan)
+    /// Read-only view of the raw states of an engine's cells, in place.
+    template<std::size_t Rank>
+    using CellView = std::mdspan<const std::uint8_t, std::dextents<Index, Rank>, std::layout_stride>;
+
+    template<std::size_t Rank>
+    CellView<Rank> make_cell_view(
+            const std::uint8_t *data,
+            const std::array<Index, Rank> &extents,
+            const std::array<Index, Rank> &strides
+    ) {
+        return CellView<Rank>{data, std::layout_stride::mapping{std::dextents<Index, Rank>{extents}, strides}};
+    }
+#else
+    /**
+     * Read-only view of the raw states of an engine's cells, in place: the subset of
+     * `std::mdspan<const std::uint8_t, std::dextents<Index, Rank>, std::layout_stride>` the engines need, for
+     * standard libraries without <mdspan>. Code written against it compiles with either.
+     */
+    template<std::size_t Rank>
+    class CellView {
+        const std::uint8_t *data_{};
+        std::array<Index, Rank> extents_{};
+        std::array<Index, Rank> strides_{};
+
+    public:
+        CellView() = default;
+
+        CellView(
+                const std::uint8_t *data,
+                const std::array<Index, Rank> &extents,
+                const std::array<Index, Rank> &strides
+        ) : data_{data}, extents_{extents}, strides_{strides} {}
+
+        static constexpr std::size_t rank() { return Rank; }
+
+        Index extent(std::size_t r) const { return extents_[r]; }
+
+        Index stride(std::size_t r) const { return strides_[r]; }
+
+        Index size() const {
+            Index size = 1;
+            for (Index extent: extents_)
+                size *= extent;
+            return size;
+        }
+
+        bool empty() const { return size() == 0; }
+
+        const std::uint8_t *data_handle() const { return data_; }
+
+        template<typename... Indices>
+            requires (sizeof...(Indices) == Rank)
+        const std::uint8_t &operator [] (Indices... indices) const {
+            std::array<Index, Rank> at{static_cast<Index>(indices)...};
+            Index offset = 0;
+            for (std::size_t r = 0; r != Rank; ++ r)
+                offset += at[r] * strides_[r];
+            return data_[offset];
+        }
+    };
+
+    template<std::size_t Rank>
+    CellView<Rank> make_cell_view(
+            const std::uint8_t *data,
+            const std::array<Index, Rank> &extents,
+            const std::array<Index, Rank> &strides
+    ) {
+        return CellView<Rank>{data, extents, strides};
+    }
+#endif
+
+    /**
+     * Copies the cells of @param view into caller memory, row-major, without allocating.
+     * @param out destination, e.g. aligned memory of a renderer
+     * @param row_pitch distance between the starts of the destination rows (innermost runs), 0 for extent(Rank - 1);
+     * outer dimensions are packed over rows of that pitch
+     * @throw errors::VIEW_EXPORT_TOO_SMALL if @param out can't hold the cells
+     */
+    template<std::size_t Rank>
+    void export_cells(const CellView<Rank> &view, std::span<std::uint8_t> out, Index row_pitch = 0) {
+        static_assert(Rank >= 1);
+        const Index run = view.extent(Rank - 1);
+        if (row_pitch == 0)
+            row_pitch = run;
+        Index rows = 1;
+        for (std::size_t r = 0; r + 1 < Rank; ++ r)
+            rows *= view.extent(r);
+        if (row_pitch < run || (rows != 0 && run != 0 && out.size() < (rows - 1) * row_pitch + run))
+            throw errors::VIEW_EXPORT_TOO_SMALL();
+        if (run == 0)
+            return;
+
+        for (Index row = 0; row != rows; ++ row) {
+            // Offset of the first cell of the row in the view: split the row number into the outer indices.
+            Index offset = 0;
+            for (Index rest = row, r = Rank - 1; r-- != 0;) {
+                offset += rest % view.extent(r) * view.stride(r);
+                rest /= view.extent(r);
+            }
+            const std::uint8_t *src = view.data_handle() + offset;
+            std::uint8_t *dst = out.data() + row * row_pitch;
+            if (view.stride(Rank - 1) == 1)
+                std::memcpy(dst, src, run);
+            else
+                for (Index c = 0; c != run; ++ c)
+                    dst[c] = src[c * view.stride(Rank - 1)];
+        }
+    }
+
+    /**
+     * Read-only view of a bit-packed generation in place: bit `j % 64` of word `j / 64` of a row is column j, bits
+     * past the width are zero.
+     */
+    struct PackedRowView {
+        const std::uint64_t *data{};
+        Index width{};
+        Index height{};
+        Index words_per_row{}; ///< Distance between row starts, in words.
+
+        std::span<const std::uint64_t> row(Index i) const {
+            return {data + i * words_per_row, (width + 63) / 64};
+        }
+
+        bool alive(Index i, Index j) const {
+            return (data[i * words_per_row + j / 64] >> (j % 64)) & 1u;
+        }
+    };
+}
+
+#endif //CPP_GAME_OF_DEATH_CELL_VIEW_HPP
@@ -0,0 +1,132 @@
+#ifndef CPP_GAME_OF_DEATH_EDIT_QUEUE_HPP
+#define CPP_GAME_OF_DEATH_EDIT_QUEUE_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "bounding_box.hpp"
+
+namespace engine {
+
+    /// Sets a single cell to a raw state.
+    struct SetCell {
+        Index i{};
+        Index j{};
+        std::uint8_t state{};
+    };
+
+    /// Sets every cell of the area to the dead state.
+    struct ClearRegion {
+        BoundingBox area;
+    };
+
+    /// Copies a pattern of raw states, row by row with @param cols columns, with its top left corner at (top, left).
+    struct PastePattern {
+        Index top{};
+        Index left{};
+        Index cols{};
+        std::vector<std::uint8_t> states;
+
+        Index rows() const { return cols == 0 ? 0 : states.size() / cols; }
+    };
+
+    using Edit = std::variant<SetCell, ClearRegion, PastePattern>;
+
+    /// Position of an edit in the total order of submissions, starting from 1.
+    using EditTicket = std::uint64_t;
+
+    /**
+     * Lock-free multi-producer single-consumer queue of edits.
+     *
+     * Any thread may push() at any time: the edit is linked to an atomic list with a single compare-and-swap and
+     * gets the next ticket. The consumer drains the whole list at once and hands the edits to it in ticket order.
+     * An edit is held back while a ticket before it is still being pushed, so edits are applied in exactly ticket order
+     * and the acknowledgement is a single watermark producers may poll or wait for.
+     */
+    class EditQueue {
+        struct Item {
+            EditTicket ticket;
+            Edit edit;
+            Item *next;
+        };
+
+        std::atomic<Item *> head_{nullptr};
+        std::atomic<EditTicket> next_ticket_{1};
+        std::atomic<EditTicket> applied_{0};
+        /// Drained items not applied yet, owned by the consumer.
+        std::vector<Item *> pending_;
+
+    public:
+        EditQueue() = default;
+
+        ~EditQueue() {
+            for (auto *item = head_.load(); item != nullptr; ) {
+                auto *next = item->next;
+                delete item;
+                item = next;
+            }
+            for (auto *item: pending_)
+                delete item;
+        }
+
+        EditQueue(const EditQueue &) = delete;
+        EditQueue &operator = (const EditQueue &) = delete;
+
+        /// Enqueues @param edit. Thread-safe and lock-free. @return ticket of the edit
+        EditTicket push(Edit edit) {
+            auto ticket = next_ticket_.fetch_add(1, std::memory_order_relaxed);
+            auto *item = new Item{ticket, std::move(edit), head_.load(std::memory_order_relaxed)};
+            while (!head_.compare_exchange_weak(item->next, item, std::memory_order_release, std::memory_order_relaxed));
+            // The consumer may have applied and freed the item already.
+            return ticket;
+        }
+
+        /**
+         * Consumer side: calls @param apply with every edit whose predecessors are all applied, in ticket order,
+         * then acknowledges them. Must not be called concurrently with itself.
+         * @return number of edits applied
+         */
+        template<typename Apply>
+        Index drain(Apply &&apply) {
+            if (head_.load(std::memory_order_relaxed) == nullptr && pending_.empty())
+                return 0;
+            for (auto *item = head_.exchange(nullptr, std::memory_order_acquire); item != nullptr; item = item->next)
+                pending_.push_back(item);
+            std::sort(pending_.begin(), pending_.end(), [](auto *a, auto *b) { return a->ticket < b->ticket; });
+
+            EditTicket expected = applied_.load(std::memory_order_relaxed) + 1;
+            Index count = 0;
+            for (; count != pending_.size() && pending_[count]->ticket == expected; ++ count, ++ expected) {
+                apply(std::as_const(pending_[count]->edit));
+                delete pending_[count];
+            }
+            pending_.erase(pending_.begin(), pending_.begin() + count);
+            if (count != 0) {
+                applied_.store(expected - 1, std::memory_order_release);
+                applied_.notify_all();
+            }
+            return count;
+        }
+
+        /// Last ticket applied; every ticket up to it is applied too.
+        EditTicket applied() const {
+            return applied_.load(std::memory_order_acquire);
+        }
+
+        bool is_applied(EditTicket ticket) const {
+            return applied() >= ticket;
+        }
+
+        /// Blocks until the edit of @param ticket is applied.
+        void wait(EditTicket ticket) const {
+            for (auto current = applied(); current < ticket; current = applied())
+                applied_.wait(current, std::memory_order_acquire);
+        }
+    };
+}
+
+#endif //CPP_GAME_OF_DEATH_EDIT_QUEUE_HPP
@@ -0,0 +1,333 @@
+#ifndef CPP_GAME_OF_DEATH_ENSEMBLE_HPP
+#define CPP_GAME_OF_DEATH_ENSEMBLE_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+#include "logger/metrics.hpp"
+#include "topology/conway_node.hpp"
+#include "cell_view.hpp"
+#include "random.hpp"
+#include "rule.hpp"
+#include "stencil.hpp"
+
+namespace engine::errors {
+    struct ENSEMBLE_OUT_OF_RANGE : public std::out_of_range {
+        ENSEMBLE_OUT_OF_RANGE() : std::out_of_range("Ensemble world or cell index is out of range") {};
+    };
+}
+
+namespace engine {
+    using conway::CellState;
+
+    /// Why a world stopped evolving.
+    enum class WorldStatus {
+        RUNNING, ///< The world still changes.
+        EXTINCT, ///< No alive cells left (and the rule can't bring them back).
+        STABLE ///< The last generation was identical to the previous one.
+    };
+
+    /// Per-world counters, updated by each generation while the world is RUNNING.
+    struct WorldStats {
+        Index population{}; ///< Alive cells.
+        Index births{}; ///< Cells became alive during the last generation.
+        Index deaths{}; ///< Cells died during the last generation.
+        Index generation{}; ///< Generation the world was last advanced to (frozen on termination).
+        WorldStatus status{WorldStatus::RUNNING};
+    };
+
+    /**
+     * A batch of many same-sized independent worlds stepped together.
+     *
+     * Worlds are interleaved in blocks of LANES: a block stores cell 0 of all its worlds, then cell 1 and so on.
+     * So every per-cell operation of the kernel is a contiguous LANES-wide loop over worlds which the compiler
+     * vectorizes, and a block of small worlds stays cache-resident for the whole generation.
+     * Blocks whose worlds have all terminated are skipped.
+     */
+    class Ensemble {
+    public:
+        /// Worlds per interleaved block (one cache line of cells).
+        static constexpr Index LANES = 64;
+
+    private:
+        Index width_;
+        Index height_;
+        Index cells_;
+        Index worlds_;
+        Index blocks_;
+        Index generation_{};
+        LifeRule rule_;
+        Index degree_;
+
+        /// Linear neighbor indices, `degree_` per cell. Missing RAW neighbors point to the always-dead cell `cells_`.
+        std::vector<Index> neighbors_;
+        std::vector<unsigned> birth_counts_;
+        std::vector<unsigned> survive_counts_;
+
+        /// Block-interleaved states: block, then cell (plus one dead padding cell), then lane.
+        std::vector<std::uint8_t> current_;
+        std::vector<std::uint8_t> next_;
+
+        std::vector<WorldStats> stats_;
+        /// Whether the block was fully terminated during the previous generation, so both buffers hold its state.
+        std::vector<bool> block_settled_;
+
+        Index block_size() const {
+            return (cells_ + 1) * LANES;
+        }
+
+        Index offset_of(Index world, Index i, Index j) const {
+            if (world >= worlds_ || i >= height_ || j >= width_)
+                throw errors::ENSEMBLE_OUT_OF_RANGE();
+            return (world / LANES) * block_size() + (j + i * width_) * LANES + world % LANES;
+        }
+
+        bool is_block_terminated(Index block) const {
+            auto first = block * LANES;
+            auto last = std::min(first + LANES, worlds_);
+            for (auto world = first; world != last; ++ world)
+                if (stats_[world].status == WorldStatus::RUNNING)
+                    return false;
+            return true;
+        }
+
+        void randomize_block(Index block, const random::Density &probability, std::uint64_t seed) {
+            std::uint8_t *cells = current_.data() + block * block_size();
+            Index lanes = std::min(LANES, worlds_ - block * LANES);
+            std::array<std::uint64_t, LANES> seeds{};
+            for (Index lane = 0; lane != lanes; ++ lane)
+                seeds[lane] = random::mix(seed, block * LANES + lane);
+            std::array<Index, LANES> population{};
+            for (Index cell = 0; cell != cells_; ++ cell)
+                for (Index lane = 0; lane != lanes; ++ lane) {
+                    auto alive = random::cell_alive(seeds[lane], cell, probability);
+                    cells[cell * LANES + lane] = alive;
+                    population[lane] += alive;
+                }
+            for (Index lane = 0; lane != lanes; ++ lane) {
+                auto &stats = stats_[block * LANES + lane];
+                stats.population = population[lane];
+                stats.status = WorldStatus::RUNNING;
+            }
+        }
+
+        void step_block(Index block) {
+            const std::uint8_t *cur = current_.data() + block * block_size();
+            std::uint8_t *nxt = next_.data() + block * block_size();
+
+            std::array<std::uint32_t, LANES> population{};
+            std::array<std::uint32_t, LANES> births{};
+            std::array<std::uint32_t, LANES> deaths{};
+            alignas(64) std::array<std::uint8_t, LANES> count{};
+
+            for (Index cell = 0; cell != cells_; ++ cell) {
+                count.fill(0);
+                const Index *neighbors = neighbors_.data() + cell * degree_;
+                for (Index k = 0; k != degree_; ++ k) {
+                    const std::uint8_t *neighbor = cur + neighbors[k] * LANES;
+                    for (Index lane = 0; lane != LANES; ++ lane)
+                        count[lane] += neighbor[lane];
+                }
+
+                const std::uint8_t *self = cur + cell * LANES;
+                std::uint8_t *out = nxt + cell * LANES;
+                for (Index lane = 0; lane != LANES; ++ lane)
+                    out[lane] = 0;
+                for (unsigned n: birth_counts_)
+                    for (Index lane = 0; lane != LANES; ++ lane)
+                        out[lane] |= (count[lane] == n) & (self[lane] ^ 1u);
+                for (unsigned n: survive_counts_)
+                    for (Index lane = 0; lane != LANES; ++ lane)
+                        out[lane] |= (count[lane] == n) & self[lane];
+
+                for (Index lane = 0; lane != LANES; ++ lane) {
+                    population[lane] += out[lane];
+                    births[lane] += out[lane] & (self[lane] ^ 1u);
+                    deaths[lane] += self[lane] & (out[lane] ^ 1u);
+                }
+            }
+
+            auto first = block * LANES;
+            auto last = std::min(first + LANES, worlds_);
+            for (auto world = first; world != last; ++ world) {
+                auto &stats = stats_[world];
+                if (stats.status != WorldStatus::RUNNING)
+                    continue;
+                auto lane = world - first;
+                stats.population = population[lane];
+                stats.births = births[lane];
+                stats.deaths = deaths[lane];
+                stats.generation = generation_ + 1;
+                if (stats.population == 0 && rule_.keeps_void())
+                    stats.status = WorldStatus::EXTINCT;
+                else if (stats.births == 0 && stats.deaths == 0)
+                    stats.status = WorldStatus::STABLE;
+            }
+        }
+
+    public:
+        /**
+         * @param width width of every world
+         * @param height height of every world
+         * @param worlds number of worlds, all initially dead
+         * @param rule transition rule shared by all worlds
+         * @param topology the way border cells are connected
+         * @param neighborhood same meaning as for make_grid()
+         */
+        Ensemble(
+                Index width,
+                Index height,
+                Index worlds,
+                LifeRule rule = LifeRule::conway(),
+                GridTopology topology = GridTopology::RAW,
+                GridNeighborhood neighborhood = GridNeighborhood::VON_NEUMANN
+        ) :
+            width_{width},
+            height_{height},
+            cells_{width * height},
+            worlds_{worlds},
+            blocks_{(worlds + LANES - 1) / LANES},
+            rule_{rule},
+            degree_{stencil(neighborhood).size()},
+            stats_(worlds),
+            block_settled_(blocks_, false)
+        {
+            neighbors_.reserve(cells_ * degree_);
+            for (Index i = 0; i != height_; ++ i)
+                for (Index j = 0; j != width_; ++ j)
+                    for (auto offset: stencil(neighborhood))
+                        neighbors_.push_back(
+                            neighbor_index(i, j, offset, width_, height_, topology).value_or(cells_)
+                        );
+
+            for (unsigned n = 0; n <= degree_; ++ n) {
+                if (rule_.next(0, n))
+                    birth_counts_.push_back(n);
+                if (rule_.next(1, n))
+                    survive_counts_.push_back(n);
+            }
+
+            current_.assign(blocks_ * block_size(), 0);
+            next_.assign(blocks_ * block_size(), 0);
+        }
+
+        Index width() const { return width_; }
+
+        Index height() const { return height_; }
+
+        /// Number of worlds.
+        Index size() const { return worlds_; }
+
+        /// Number of generations performed by step().
+        Index generation() const { return generation_; }
+
+        CellState get(Index world, Index i, Index j) const {
+            return current_[offset_of(world, i, j)] ? CellState::ALIVE : CellState::DEAD;
+        }
+
+        /**
+         * Current generation of @param world in place, indexed [i, j]: cells are LANES bytes apart, interleaved with
+         * the other worlds of the block. Valid until the next step.
+         */
+        CellView<2> view(Index world) const {
+            return make_cell_view<2>(
+                current_.data() + offset_of(world, 0, 0), {height_, width_}, {width_ * LANES, LANES}
+            );
+        }
+
+        /// Sets a cell of the current generation. Editing a terminated world makes it RUNNING again.
+        void set(Index world, Index i, Index j, CellState state) {
+            auto &cell = current_[offset_of(world, i, j)];
+            auto value = static_cast<std::uint8_t>(state == CellState::ALIVE);
+            if (cell == value)
+                return;
+            cell = value;
+            auto &stats = stats_[world];
+            stats.population = value ? stats.population + 1 : stats.population - 1;
+            stats.status = WorldStatus::RUNNING;
+            block_settled_[world / LANES] = false;
+        }
+
+        /**
+         * Replaces every world with a random soup: a cell is alive with probability @param density.
+         * World w holds the same soup as a World of the same size randomized with seed `random::mix(seed, w)`,
+         * whatever the number of worlds, so a single world of the batch can be replayed. Every world becomes RUNNING
+         * again.
+         * @throw errors::RANDOM_BAD_DENSITY if @param density is not within [0, 1]
+         */
+        void randomize(double density, std::uint64_t seed) {
+            const random::Density probability{density};
+            metrics::ScopedTimer timer{metrics::Phase::GRID_BUILD};
+            for (Index block = 0; block != blocks_; ++ block)
+                randomize_block(block, probability, seed);
+            std::fill(block_settled_.begin(), block_settled_.end(), false);
+        }
+
+        /// Same as randomize(@param density, @param seed), with the blocks split over the tasks of @param pool.
+        template<typename Pool>
+        void randomize(double density, std::uint64_t seed, Pool &pool) {
+            const random::Density probability{density};
+            metrics::ScopedTimer timer{metrics::Phase::GRID_BUILD};
+            pool.run(blocks_, [this, &probability, seed](Index block, Index) {
+                randomize_block(block, probability, seed);
+            });
+            // Packed bits: cleared here rather than by the tasks, which would race on shared words.
+            std::fill(block_settled_.begin(), block_settled_.end(), false);
+        }
+
+        const WorldStats &stats(Index world) const {
+            if (world >= worlds_)
+                throw errors::ENSEMBLE_OUT_OF_RANGE();
+            return stats_[world];
+        }
+
+        bool is_terminated(Index world) const {
+            return stats(world).status != WorldStatus::RUNNING;
+        }
+
+        bool all_terminated() const {
+            for (Index block = 0; block != blocks_; ++ block)
+                if (!is_block_terminated(block))
+                    return false;
+            return true;
+        }
+
+        /// Advances every running world by one generation.
+        void step() {
+            {
+                metrics::ScopedTimer timer{metrics::Phase::EXEC};
+                for (Index block = 0; block != blocks_; ++ block) {
+                    bool terminated = is_block_terminated(block);
+                    if (terminated && block_settled_[block])
+                        continue;
+                    step_block(block);
+                    block_settled_[block] = terminated;
+                }
+            }
+            {
+                metrics::ScopedTimer timer{metrics::Phase::COMMIT};
+                current_.swap(next_);
+                ++ generation_;
+            }
+            metrics::publish(generation_);
+        }
+
+        /**
+         * Steps until every world has terminated or @param max_generations are performed.
+         * @return number of generations performed
+         */
+        Index run(Index max_generations) {
+            Index performed = 0;
+            while (performed != max_generations && !all_terminated()) {
+                step();
+                ++ performed;
+            }
+            return performed;
+        }
+    };
+}
+
+#endif //CPP_GAME_OF_DEATH_ENSEMBLE_HPP
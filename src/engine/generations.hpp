@@ -0,0 +1,33 @@
+#ifndef CPP_GAME_OF_DEATH_GENERATIONS_HPP
+#define CPP_GAME_OF_DEATH_GENERATIONS_HPP
+
+#include <cstdint>
+
+#include "topology/node.hpp"
+#include "rule.hpp"
+
+namespace engine {
+
+    using GenerationsNode = topology::Node<std::uint8_t>;
+
+    /**
+     * Node-graph executor of a GenerationsRule.
+     * It's the per-node reference for the multi-state World: slow, but built from the same bricks as
+     * conway::ConwayNodeExecutor, so it can be used with make_grid().
+     */
+    class GenerationsNodeExecutor : public topology::BatchNodeExecutor<GenerationsNodeExecutor, std::uint8_t> {
+        GenerationsRule rule_;
+
+    public:
+        explicit GenerationsNodeExecutor(GenerationsRule rule) : rule_{rule} {};
+
+        void exec() override {
+            unsigned firing = 0;
+            for (auto *neighbor: *node()->neighborhood())
+                firing += neighbor->value()->get() == TransitionTable::FIRING;
+            node()->value()->stage(rule_.next(node()->value()->get(), firing));
+        }
+    };
+}
+
+#endif //CPP_GAME_OF_DEATH_GENERATIONS_HPP
@@ -0,0 +1,107 @@
+#ifndef CPP_GAME_OF_DEATH_KERNEL_HPP
+#define CPP_GAME_OF_DEATH_KERNEL_HPP
+
+#include <array>
+#include <bit>
+#include <cstdint>
+
+#include "rule.hpp"
+#include "stencil.hpp"
+
+namespace engine {
+
+    /// Binary states are summed directly, multi-state ones are compared with FIRING first.
+    template<bool Binary>
+    inline unsigned firing(std::uint8_t state) {
+        if constexpr (Binary)
+            return state;
+        else
+            return state == TransitionTable::FIRING;
+    }
+
+    /**
+     * One generation of the rows [@param r0, @param r1) and columns [@param c0, @param c1) of a buffer with
+     * @param stride. The range must have at least one cell of margin, so there are no boundary checks.
+     */
+    template<bool Moore, bool Binary>
+    void relax(
+            const TransitionTable &transitions,
+            const std::uint8_t *src,
+            std::uint8_t *dst,
+            Index stride,
+            Index r0,
+            Index r1,
+            Index c0,
+            Index c1
+    ) {
+        const std::uint8_t *table = transitions.data();
+        constexpr Index table_stride = TransitionTable::STRIDE;
+        for (Index r = r0; r < r1; ++ r) {
+            const std::uint8_t *up = src + (r - 1) * stride;
+            const std::uint8_t *mid = src + r * stride;
+            const std::uint8_t *down = src + (r + 1) * stride;
+            std::uint8_t *out = dst + r * stride;
+            for (Index c = c0; c < c1; ++ c) {
+                unsigned count = firing<Binary>(up[c]) + firing<Binary>(down[c]) +
+                                 firing<Binary>(mid[c - 1]) + firing<Binary>(mid[c + 1]);
+                if constexpr (Moore)
+                    count += firing<Binary>(up[c - 1]) + firing<Binary>(up[c + 1]) +
+                             firing<Binary>(down[c - 1]) + firing<Binary>(down[c + 1]);
+                out[c] = table[mid[c] * table_stride + count];
+            }
+        }
+    }
+
+    /// Bit-sliced neighbor counts of 64 cells: plane b holds bit b of every count, so counts go up to 15.
+    using BitCounts = std::array<std::uint64_t, 4>;
+
+    /// Adds the bits of @param x to @param counts.
+    constexpr void add_bits(BitCounts &counts, std::uint64_t x) {
+        for (auto &plane: counts) {
+            std::uint64_t carry = plane & x;
+            plane ^= x;
+            x = carry;
+        }
+    }
+
+    /// Cells whose count in @param counts is any count of @param mask.
+    constexpr std::uint64_t matching_bits(const BitCounts &counts, std::uint32_t mask) {
+        std::uint64_t result = 0;
+        for (; mask != 0; mask &= mask - 1) {
+            unsigned count = std::countr_zero(mask);
+            std::uint64_t equal = ~std::uint64_t{0};
+            for (unsigned bit = 0; bit != 4; ++ bit)
+                equal &= (count >> bit) & 1u ? counts[bit] : ~counts[bit];
+            result |= equal;
+        }
+        return result;
+    }
+
+    /// Next states of the 64 cells @param self under @param rule, given their neighbor @param counts.
+    constexpr std::uint64_t next_bits(const LifeRule &rule, std::uint64_t self, const BitCounts &counts) {
+        return (~self & matching_bits(counts, rule.birth)) | (self & matching_bits(counts, rule.survive));
+    }
+
+    /// relax() for the @param neighborhood and the kind of the @param transitions.
+    inline void relax(
+            const TransitionTable &transitions,
+            GridNeighborhood neighborhood,
+            const std::uint8_t *src,
+            std::uint8_t *dst,
+            Index stride,
+            Index r0,
+            Index r1,
+            Index c0,
+            Index c1
+    ) {
+        bool moore = neighborhood == GridNeighborhood::MOORE;
+        if (transitions.is_binary())
+            moore ? relax<true, true>(transitions, src, dst, stride, r0, r1, c0, c1)
+                  : relax<false, true>(transitions, src, dst, stride, r0, r1, c0, c1);
+        else
+            moore ? relax<true, false>(transitions, src, dst, stride, r0, r1, c0, c1)
+                  : relax<false, false>(transitions, src, dst, stride, r0, r1, c0, c1);
+    }
+}
+
+#endif //CPP_GAME_OF_DEATH_KERNEL_HPP
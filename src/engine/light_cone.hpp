@@ -0,0 +1,264 @@
+#ifndef CPP_GAME_OF_DEATH_LIGHT_CONE_HPP
+#define CPP_GAME_OF_DEATH_LIGHT_CONE_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "logger/metrics.hpp"
+#include "bounding_box.hpp"
+#include "kernel.hpp"
+#include "world.hpp"
+
+namespace engine::errors {
+    struct LIGHT_CONE_STALE : public std::logic_error {
+        LIGHT_CONE_STALE() : std::logic_error("The world was stepped since the light cone was bound, call reset()") {};
+    };
+
+    struct LIGHT_CONE_BAD_TILE : public std::invalid_argument {
+        LIGHT_CONE_BAD_TILE() : std::invalid_argument("Light cone tile side must be positive") {};
+    };
+}
+
+namespace engine {
+
+    /**
+     * Lazy queries of a World's future: the states of a region at a later generation, computed over the backward
+     * light cone of the region only.
+     *
+     * The world is cut into square tiles of `tile` cells. As the neighborhood radius is 1, a tile `tile` generations
+     * later depends on the 3 x 3 tiles around it only, so a query walks back from the target generation through the
+     * previous multiples of `tile`, collects the tiles each level needs, then computes them upwards. Every computed
+     * tile is memoized by (generation, tile), so repeated and overlapping queries reuse each other's work. The cost
+     * of a query is proportional to the volume of its light cone, not to the world area times the generations.
+     *
+     * Generations are counted from the world's generation when the cone was bound. The world must not change while
+     * the cone is used: stepping it is detected, but cells set in place are not; call reset() after any change.
+     */
+    class LightCone {
+        const World &world_;
+        Index tile_;
+        Index tile_rows_;
+        Index tile_cols_;
+        Index generation_;
+        /// Computed tiles, `tile_` x `tile_` cells row by row (clipped ones padded with dead cells).
+        std::unordered_map<std::uint64_t, std::vector<std::uint8_t>> memo_;
+        Index computed_{};
+
+        std::vector<std::uint8_t> front_;
+        std::vector<std::uint8_t> back_;
+        std::vector<Index> rows_;
+        std::vector<Index> columns_;
+
+        std::uint64_t key(Index generation, Index tile) const {
+            return static_cast<std::uint64_t>(generation) * tile_rows_ * tile_cols_ + tile;
+        }
+
+        BoundingBox tile_rect(Index tile) const {
+            Index top = (tile / tile_cols_) * tile_;
+            Index left = (tile % tile_cols_) * tile_;
+            return BoundingBox{
+                top,
+                left,
+                std::min(top + tile_, world_.height()),
+                std::min(left + tile_, world_.width())
+            };
+        }
+
+        /// Generation the tiles of @param generation are computed from: the previous multiple of the tile side.
+        Index previous(Index generation) const {
+            Index steps = generation % tile_;
+            return generation - (steps == 0 ? tile_ : steps);
+        }
+
+        /**
+         * World coordinates of the positions of an axis window starting @param halo cells before @param origin,
+         * `size` stands for a cell outside a RAW world. Same folding as World's temporal blocking.
+         * @return the range of positions inside the world
+         */
+        std::pair<Index, Index> fold(Index origin, Index count, Index halo, Index size, std::vector<Index> &out) const {
+            out.assign(count, size);
+            Index first = count, last = 0;
+            for (Index pos = 0; pos != count; ++ pos) {
+                auto shift = static_cast<int>(pos) - static_cast<int>(halo);
+                if (auto coordinate = neighbor_index(0, origin, {0, shift}, size, 1, world_.topology())) {
+                    out[pos] = *coordinate;
+                    first = std::min(first, pos);
+                    last = pos + 1;
+                }
+            }
+            return {first, last};
+        }
+
+        /// Cell (@param i, @param tile_col * tile_) of @param generation: the world itself or a memoized tile.
+        const std::uint8_t *tile_row(Index generation, Index i, Index tile_col) const {
+            if (generation == 0)
+                return world_.row_cells(i).data() + tile_col * tile_;
+            Index tile = tile_col + (i / tile_) * tile_cols_;
+            return memo_.at(key(generation, tile)).data() + (i % tile_) * tile_;
+        }
+
+        /// Appends the tiles of the previous level @param tile of @param generation depends on.
+        void dependencies(Index generation, Index tile, std::vector<Index> &out) {
+            Index steps = generation - previous(generation);
+            BoundingBox rect = tile_rect(tile);
+            fold(rect.top, rect.bottom - rect.top + 2 * steps, steps, world_.height(), rows_);
+            fold(rect.left, rect.right - rect.left + 2 * steps, steps, world_.width(), columns_);
+            std::vector<Index> tile_rows, tile_cols;
+            for (Index i: rows_)
+                if (i != world_.height())
+                    tile_rows.push_back(i / tile_);
+            for (Index j: columns_)
+                if (j != world_.width())
+                    tile_cols.push_back(j / tile_);
+            for (auto *tiles: {&tile_rows, &tile_cols}) {
+                std::sort(tiles->begin(), tiles->end());
+                tiles->erase(std::unique(tiles->begin(), tiles->end()), tiles->end());
+            }
+            for (Index r: tile_rows)
+                for (Index c: tile_cols)
+                    out.push_back(c + r * tile_cols_);
+        }
+
+        /// Computes @param tile of @param generation from the previous level, which must be available.
+        void compute(Index generation, Index tile) {
+            const Index from = previous(generation);
+            const Index steps = generation - from;
+            BoundingBox rect = tile_rect(tile);
+            const Index rows = rect.bottom - rect.top + 2 * steps;
+            const Index cols = rect.right - rect.left + 2 * steps;
+            auto [inside_top, inside_bottom] = fold(rect.top, rows, steps, world_.height(), rows_);
+            auto [inside_left, inside_right] = fold(rect.left, cols, steps, world_.width(), columns_);
+            front_.assign(rows * cols, 0);
+            back_.assign(rows * cols, 0);
+
+            // Cells outside a RAW world are never loaded nor computed, so they stay dead.
+            for (Index r = inside_top; r < inside_bottom; ++ r) {
+                std::uint8_t *dst = front_.data() + r * cols;
+                const std::uint8_t *src = nullptr;
+                Index src_col = world_.width();
+                for (Index c = inside_left; c < inside_right; ++ c) {
+                    Index j = columns_[c];
+                    if (j / tile_ != src_col) {
+                        src_col = j / tile_;
+                        src = tile_row(from, rows_[r], src_col);
+                    }
+                    dst[c] = src[j % tile_];
+                }
+            }
+
+            for (Index s = 1; s <= steps; ++ s) {
+                relax(
+                    world_.transitions(),
+                    world_.neighborhood(),
+                    front_.data(),
+                    back_.data(),
+                    cols,
+                    std::max(s, inside_top),
+                    std::min(rows - s, inside_bottom),
+                    std::max(s, inside_left),
+                    std::min(cols - s, inside_right)
+                );
+                front_.swap(back_);
+            }
+
+            std::vector<std::uint8_t> cells(tile_ * tile_, 0);
+            for (Index i = rect.top; i != rect.bottom; ++ i)
+                std::copy_n(
+                    front_.data() + (i - rect.top + steps) * cols + steps,
+                    rect.right - rect.left,
+                    cells.data() + (i - rect.top) * tile_
+                );
+            memo_[key(generation, tile)] = std::move(cells);
+            ++ computed_;
+        }
+
+    public:
+        /**
+         * @param world the world whose future is queried, from its current generation
+         * @param tile side of the memoized tiles, also the number of generations computed at once
+         * @throw errors::LIGHT_CONE_BAD_TILE if @param tile is 0
+         */
+        explicit LightCone(const World &world, Index tile = 16) :
+            world_{world},
+            tile_{tile},
+            tile_rows_{tile == 0 ? 0 : (world.height() + tile - 1) / tile},
+            tile_cols_{tile == 0 ? 0 : (world.width() + tile - 1) / tile},
+            generation_{world.generation()}
+        {
+            if (tile == 0)
+                throw errors::LIGHT_CONE_BAD_TILE();
+        }
+
+        Index tile() const { return tile_; }
+
+        /// World generation the queries count from.
+        Index generation() const { return generation_; }
+
+        /// Number of memoized tiles.
+        Index cached_tiles() const { return memo_.size(); }
+
+        /// Number of tiles computed since the construction, including the ones dropped by reset().
+        Index computed_tiles() const { return computed_; }
+
+        /// Drops the memoized tiles and counts the generations from the world's current one again.
+        void reset() {
+            memo_.clear();
+            generation_ = world_.generation();
+        }
+
+        /**
+         * Raw states of @param region, row by row, @param generations after generation().
+         * @throw errors::WORLD_OUT_OF_RANGE if @param region reaches outside the world
+         * @throw errors::LIGHT_CONE_STALE if the world was stepped since the cone was bound
+         */
+        std::vector<std::uint8_t> query(const BoundingBox &region, Index generations) {
+            if (region.bottom > world_.height() || region.right > world_.width())
+                throw errors::WORLD_OUT_OF_RANGE();
+            if (world_.generation() != generation_)
+                throw errors::LIGHT_CONE_STALE();
+            if (region.top >= region.bottom || region.left >= region.right)
+                return {};
+            metrics::ScopedTimer timer{metrics::Phase::EXEC};
+
+            // Missing tiles per level, from the target generation down.
+            std::vector<std::pair<Index, std::vector<Index>>> levels;
+            std::vector<Index> wanted;
+            for (Index r = region.top / tile_; r <= (region.bottom - 1) / tile_; ++ r)
+                for (Index c = region.left / tile_; c <= (region.right - 1) / tile_; ++ c)
+                    wanted.push_back(c + r * tile_cols_);
+            for (Index generation = generations; generation != 0 && !wanted.empty(); generation = previous(generation)) {
+                std::sort(wanted.begin(), wanted.end());
+                wanted.erase(std::unique(wanted.begin(), wanted.end()), wanted.end());
+                std::erase_if(wanted, [this, generation](Index tile) { return memo_.contains(key(generation, tile)); });
+                std::vector<Index> below;
+                if (previous(generation) != 0)
+                    for (Index tile: wanted)
+                        dependencies(generation, tile, below);
+                levels.emplace_back(generation, std::move(wanted));
+                wanted = std::move(below);
+            }
+            for (auto level = levels.rbegin(); level != levels.rend(); ++ level)
+                for (Index tile: level->second)
+                    compute(level->first, tile);
+
+            std::vector<std::uint8_t> states;
+            states.reserve((region.bottom - region.top) * (region.right - region.left));
+            for (Index i = region.top; i != region.bottom; ++ i)
+                for (Index j = region.left; j != region.right; ++ j)
+                    states.push_back(tile_row(generations, i, j / tile_)[j % tile_]);
+            return states;
+        }
+
+        /// Raw state of cell (@param i, @param j), @param generations after generation(). @see query()
+        std::uint8_t state(Index i, Index j, Index generations) {
+            return query(BoundingBox{i, j, i + 1, j + 1}, generations).at(0);
+        }
+    };
+}
+
+#endif //CPP_GAME_OF_DEATH_LIGHT_CONE_HPP
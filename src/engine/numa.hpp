@@ -0,0 +1,168 @@
+#ifndef CPP_GAME_OF_DEATH_NUMA_HPP
+#define CPP_GAME_OF_DEATH_NUMA_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <exception>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "topology/node_array.hpp"
+
+/**
+ * NUMA helpers without libnuma: the machine layout is read from sysfs, threads are pinned with
+ * pthread_setaffinity_np() and page placement is queried with the move_pages(2) system call.
+ * On other platforms everything degrades to a single node and no pinning.
+ */
+namespace engine::numa {
+    using topology::Index;
+
+    /// How workers are bound to CPUs.
+    enum class AffinityPolicy {
+        NONE, ///< Threads float, the OS decides.
+        COMPACT, ///< Fill the CPUs of the first node, then the next one.
+        SCATTER ///< Round-robin over the nodes, so every node gets workers (and their memory).
+    };
+
+    /// CPUs of each NUMA node.
+    struct MachineLayout {
+        std::vector<std::vector<int>> node_cpus;
+
+        Index nodes() const { return node_cpus.size(); }
+    };
+
+    namespace assets {
+        /// Parses the sysfs cpulist format, e.g. "0-3,8,10-11".
+        inline std::vector<int> parse_cpu_list(const std::string &list) {
+            std::vector<int> cpus;
+            std::size_t pos = 0;
+            while (pos < list.size()) {
+                auto end = list.find(',', pos);
+                if (end == std::string::npos)
+                    end = list.size();
+                auto range = list.substr(pos, end - pos);
+                auto dash = range.find('-');
+                try {
+                    int first = std::stoi(range.substr(0, dash));
+                    int last = dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+                    for (int cpu = first; cpu <= last; ++ cpu)
+                        cpus.push_back(cpu);
+                } catch (std::exception &) {
+                    // Blank or malformed piece: skip it.
+                }
+                pos = end + 1;
+            }
+            return cpus;
+        }
+    }
+
+    /// Discovers NUMA nodes and their CPUs. Falls back to one node with all hardware threads.
+    inline MachineLayout machine_layout() {
+        MachineLayout layout;
+        for (int node = 0; ; ++ node) {
+            std::ifstream file{"/sys/devices/system/node/node" + std::to_string(node) + "/cpulist"};
+            if (!file)
+                break;
+            std::string list;
+            std::getline(file, list);
+            layout.node_cpus.push_back(assets::parse_cpu_list(list));
+        }
+        if (layout.node_cpus.empty()) {
+            layout.node_cpus.emplace_back();
+            for (unsigned cpu = 0; cpu < std::max(1u, std::thread::hardware_concurrency()); ++ cpu)
+                layout.node_cpus.back().push_back(static_cast<int>(cpu));
+        }
+        return layout;
+    }
+
+    /**
+     * CPUs for @param workers workers under @param policy: worker w is to be pinned to the w-th CPU.
+     * @return empty vector for AffinityPolicy::NONE
+     */
+    inline std::vector<int> assign_cpus(Index workers, AffinityPolicy policy, const MachineLayout &layout) {
+        std::vector<int> order;
+        if (policy == AffinityPolicy::COMPACT) {
+            for (auto &cpus: layout.node_cpus)
+                order.insert(order.end(), cpus.begin(), cpus.end());
+        } else if (policy == AffinityPolicy::SCATTER) {
+            for (Index k = 0; order.size() < workers; ++ k) {
+                bool any = false;
+                for (auto &cpus: layout.node_cpus)
+                    if (k < cpus.size()) {
+                        order.push_back(cpus[k]);
+                        any = true;
+                    }
+                if (!any)
+                    break;
+            }
+        }
+        if (order.empty())
+            return order;
+
+        std::vector<int> assigned;
+        for (Index worker = 0; worker != workers; ++ worker)
+            assigned.push_back(order[worker % order.size()]);
+        return assigned;
+    }
+
+    /// Binds the calling thread to @param cpu. @return false if the platform refused or doesn't support it.
+    inline bool pin_current_thread(int cpu) {
+#ifdef __linux__
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpu, &set);
+        return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+        (void) cpu;
+        return false;
+#endif
+    }
+
+    /**
+     * Number of resident pages of [@param data, @param data + @param bytes) on each NUMA node.
+     * Pages not touched yet are not counted.
+     * @return pages by node index; empty if the platform can't tell
+     */
+    inline std::vector<Index> page_placement(const void *data, Index bytes) {
+        std::vector<Index> pages_by_node;
+#if defined(__linux__) && defined(SYS_move_pages)
+        const auto page = static_cast<std::uintptr_t>(sysconf(_SC_PAGESIZE));
+        auto first = reinterpret_cast<std::uintptr_t>(data) / page * page;
+        auto last = reinterpret_cast<std::uintptr_t>(data) + bytes;
+        constexpr Index BATCH = 1024;
+        std::vector<void *> pages;
+        std::vector<int> status;
+        for (auto address = first; address < last; ) {
+            pages.clear();
+            for (; address < last && pages.size() != BATCH; address += page)
+                pages.push_back(reinterpret_cast<void *>(address));
+            status.assign(pages.size(), -1);
+            // With no target nodes move_pages() only reports where each page lives.
+            if (syscall(SYS_move_pages, 0, pages.size(), pages.data(), nullptr, status.data(), 0) != 0)
+                return {};
+            for (int node: status) {
+                if (node < 0)
+                    continue;
+                if (pages_by_node.size() <= static_cast<Index>(node))
+                    pages_by_node.resize(node + 1, 0);
+                ++ pages_by_node[node];
+            }
+        }
+#else
+        (void) data;
+        (void) bytes;
+#endif
+        return pages_by_node;
+    }
+}
+
+#endif //CPP_GAME_OF_DEATH_NUMA_HPP
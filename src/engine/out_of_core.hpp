@@ -0,0 +1,475 @@
+#ifndef CPP_GAME_OF_DEATH_OUT_OF_CORE_HPP
+#define CPP_GAME_OF_DEATH_OUT_OF_CORE_HPP
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <future>
+#include <optional>
+#include <stdexcept>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "logger/metrics.hpp"
+#include "topology/conway_node.hpp"
+#include "cell_view.hpp"
+#include "kernel.hpp"
+#include "random.hpp"
+#include "rule.hpp"
+#include "stencil.hpp"
+
+namespace engine::errors {
+    struct OUT_OF_CORE_IO : public std::runtime_error {
+        /// Failure of the call @param what, explained by errno.
+        OUT_OF_CORE_IO(const std::string &what) : OUT_OF_CORE_IO(what, std::strerror(errno)) {};
+
+        OUT_OF_CORE_IO(const std::string &what, const std::string &reason) :
+            std::runtime_error("Out-of-core world I/O failed: " + what + ": " + reason) {};
+    };
+
+    struct OUT_OF_CORE_OUT_OF_RANGE : public std::out_of_range {
+        OUT_OF_CORE_OUT_OF_RANGE() : std::out_of_range("Out-of-core world cell index is out of range") {};
+    };
+
+    struct OUT_OF_CORE_BAD_CONFIG : public std::invalid_argument {
+        OUT_OF_CORE_BAD_CONFIG() : std::invalid_argument(
+            "Out-of-core world size must be positive and its rule must fit the neighborhood"
+        ) {};
+    };
+}
+
+namespace engine {
+    using conway::CellState;
+
+    /**
+     * Engine for binary worlds larger than the memory: the generations live in two files, one bit per cell.
+     *
+     * Rows are packed into 64-bit words (bit b of word w is column 64 w + b). A generation streams the current file
+     * band by band through a fixed window: the next band is read ahead and the previous one written back
+     * asynchronously (double buffering both ways) while the current one is computed, so disk and CPU overlap and the
+     * files are only read and written sequentially. A band is read with the row below it; the row above is carried
+     * over from the previous band. The next generation goes into the other file and the files swap roles.
+     *
+     * The kernel adds the 4 or 8 neighbor bits of 64 cells at once into bit-sliced counters, then applies the rule
+     * masks, so any LifeRule runs at the same speed. Memory use is about `memory_budget` bytes whatever the world size.
+     * Both files are removed by the destructor.
+     */
+    class OutOfCoreWorld {
+        using Word = std::uint64_t;
+        static constexpr Index WORD_BITS = 64;
+
+        Index width_;
+        Index height_;
+        Index words_;
+        Index band_rows_;
+        LifeRule rule_;
+        GridTopology topology_;
+        GridNeighborhood neighborhood_;
+        std::array<std::filesystem::path, 2> paths_;
+        std::array<int, 2> files_{-1, -1};
+        int current_{0};
+        Index population_{};
+        Index generation_{};
+
+        /// Read-ahead bands (band_rows_ + 1 rows each) and write-behind bands (band_rows_ rows each).
+        std::array<std::vector<Word>, 2> input_;
+        std::array<std::vector<Word>, 2> output_;
+        std::vector<Word> above_;
+        std::vector<Word> below_;
+        std::vector<Word> west_;
+        std::vector<Word> east_;
+
+        Index row_bytes() const { return words_ * sizeof(Word); }
+
+        /// Closes and deletes the generation files opened so far.
+        void close_files() {
+            for (int file = 0; file != 2; ++ file)
+                if (files_[file] >= 0) {
+                    ::close(files_[file]);
+                    files_[file] = -1;
+                    std::error_code ignored;
+                    std::filesystem::remove(paths_[file], ignored);
+                }
+        }
+
+        Word last_word_mask() const {
+            Index bits = width_ % WORD_BITS;
+            return bits == 0 ? ~Word{0} : (Word{1} << bits) - 1;
+        }
+
+        static void read_at(int file, Word *data, Index bytes, Index offset) {
+            auto *cursor = reinterpret_cast<char *>(data);
+            while (bytes != 0) {
+                auto done = ::pread(file, cursor, bytes, static_cast<off_t>(offset));
+                if (done < 0)
+                    throw errors::OUT_OF_CORE_IO("pread");
+                if (done == 0)
+                    throw errors::OUT_OF_CORE_IO("pread", "unexpected end of file");
+                cursor += done;
+                bytes -= done;
+                offset += done;
+            }
+        }
+
+        static void write_at(int file, const Word *data, Index bytes, Index offset) {
+            auto *cursor = reinterpret_cast<const char *>(data);
+            while (bytes != 0) {
+                auto done = ::pwrite(file, cursor, bytes, static_cast<off_t>(offset));
+                if (done < 0)
+                    throw errors::OUT_OF_CORE_IO("pwrite");
+                if (done == 0)
+                    throw errors::OUT_OF_CORE_IO("pwrite", "no bytes written");
+                cursor += done;
+                bytes -= done;
+                offset += done;
+            }
+        }
+
+        void read_rows(int file, Index first, Index count, Word *data) const {
+            read_at(file, data, count * row_bytes(), first * row_bytes());
+        }
+
+        void write_rows(int file, Index first, Index count, const Word *data) const {
+            write_at(file, data, count * row_bytes(), first * row_bytes());
+        }
+
+        /**
+         * Index of the cell seen past the start (@param past_end false, at -1) or the end (true, at @param size) of
+         * a side of @param size cells, std::nullopt for RAW. Kept in Index: sides may exceed the range of an Offset.
+         */
+        std::optional<Index> fold_outside(bool past_end, Index size) const {
+            switch (topology_) {
+                case GridTopology::TORUS:
+                    return past_end ? 0 : size - 1;
+                case GridTopology::REFLECT:
+                    return past_end ? size - 1 : 0;
+                default:
+                    return std::nullopt;
+            }
+        }
+
+        /// Row of the current generation above the first row (@param below false) or below the last one (true).
+        void read_boundary_row(bool below, std::vector<Word> &row) const {
+            auto folded = fold_outside(below, height_);
+            if (!folded) {
+                std::fill(row.begin(), row.end(), 0);
+                return;
+            }
+            read_rows(files_[current_], *folded, 1, row.data());
+        }
+
+        /// Bit of @param row seen west of its first column (@param east false) or east of its last one (true).
+        Word boundary_bit(const Word *row, bool east) const {
+            auto folded = fold_outside(east, width_);
+            if (!folded)
+                return 0;
+            return (row[*folded / WORD_BITS] >> (*folded % WORD_BITS)) & 1u;
+        }
+
+        /// Neighbors on the west (column - 1) and on the east (column + 1) of every cell of @param row.
+        void shift_row(const Word *row, Word *west, Word *east) const {
+            for (Index w = 0; w != words_; ++ w) {
+                west[w] = (row[w] << 1) | (w != 0 ? row[w - 1] >> (WORD_BITS - 1) : 0);
+                east[w] = (row[w] >> 1) | (w + 1 != words_ ? row[w + 1] << (WORD_BITS - 1) : 0);
+            }
+            west[0] |= boundary_bit(row, false);
+            Index last = width_ - 1;
+            east[last / WORD_BITS] |= boundary_bit(row, true) << (last % WORD_BITS);
+            west[words_ - 1] &= last_word_mask();
+        }
+
+        /**
+         * Next generation of @param count rows: row r of @param rows has row r - 1 above it (@param above for r = 0)
+         * and row r + 1 below it; @param rows holds count + 1 rows.
+         * @return alive cells of the computed rows
+         */
+        Index exec_band(const Word *above, const Word *rows, Index count, Word *out) {
+            const bool moore = neighborhood_ == GridNeighborhood::MOORE;
+            const Word mask = last_word_mask();
+            std::vector<Word> &west = west_;
+            std::vector<Word> &east = east_;
+            Index population = 0;
+            // west_ / east_ keep 3 rows of shifts: above, current, below, rotating by one row per step.
+            auto shifted = [this, &west, &east](Index slot) {
+                return std::pair{west.data() + slot * words_, east.data() + slot * words_};
+            };
+            if (moore) {
+                shift_row(above, shifted(0).first, shifted(0).second);
+                shift_row(rows, shifted(1).first, shifted(1).second);
+            }
+            for (Index r = 0; r != count; ++ r) {
+                const Word *up = r == 0 ? above : rows + (r - 1) * words_;
+                const Word *mid = rows + r * words_;
+                const Word *down = rows + (r + 1) * words_;
+                if (!moore)
+                    shift_row(mid, shifted(1).first, shifted(1).second);
+                else
+                    shift_row(down, shifted((r + 2) % 3).first, shifted((r + 2) % 3).second);
+                auto [up_west, up_east] = shifted(r % 3);
+                auto [mid_west, mid_east] = shifted(moore ? (r + 1) % 3 : 1);
+                auto [down_west, down_east] = shifted((r + 2) % 3);
+                Word *next = out + r * words_;
+                for (Index w = 0; w != words_; ++ w) {
+                    BitCounts sum{};
+                    add_bits(sum, up[w]);
+                    add_bits(sum, down[w]);
+                    add_bits(sum, mid_west[w]);
+                    add_bits(sum, mid_east[w]);
+                    if (moore) {
+                        add_bits(sum, up_west[w]);
+                        add_bits(sum, up_east[w]);
+                        add_bits(sum, down_west[w]);
+                        add_bits(sum, down_east[w]);
+                    }
+                    Word self = mid[w];
+                    next[w] = next_bits(rule_, self, sum);
+                }
+                next[words_ - 1] &= mask;
+                for (Index w = 0; w != words_; ++ w)
+                    population += std::popcount(next[w]);
+            }
+            return population;
+        }
+
+        Index word_offset(Index i, Index j) const {
+            if (i >= height_ || j >= width_)
+                throw errors::OUT_OF_CORE_OUT_OF_RANGE();
+            return i * row_bytes() + j / WORD_BITS * sizeof(Word);
+        }
+
+    public:
+        /**
+         * Creates an all-dead world in two files of @param directory.
+         * @param width world width
+         * @param height world height
+         * @param rule Life-like rule over 4 or 8 neighbors
+         * @param topology the way border cells are connected
+         * @param neighborhood same meaning as for make_grid()
+         * @param memory_budget bytes of the streaming window; bands get as many rows as fit, at least one
+         * @throw errors::OUT_OF_CORE_BAD_CONFIG on zero sizes or rule counts above the neighborhood size
+         * @throw errors::OUT_OF_CORE_IO if the files can't be created
+         */
+        OutOfCoreWorld(
+                const std::filesystem::path &directory,
+                Index width,
+                Index height,
+                LifeRule rule = LifeRule::conway(),
+                GridTopology topology = GridTopology::RAW,
+                GridNeighborhood neighborhood = GridNeighborhood::VON_NEUMANN,
+                Index memory_budget = Index{64} << 20
+        ) :
+            width_{width},
+            height_{height},
+            words_{(width + WORD_BITS - 1) / WORD_BITS},
+            rule_{rule},
+            topology_{topology},
+            neighborhood_{neighborhood}
+        {
+            const Index neighbors = stencil(neighborhood).size();
+            if (width == 0 || height == 0 || (rule.birth | rule.survive) >> (neighbors + 1) != 0)
+                throw errors::OUT_OF_CORE_BAD_CONFIG();
+            // Two input bands of band_rows_ + 1 rows, two output bands and 8 more rows of halos and shifts.
+            Index rows = memory_budget / row_bytes();
+            band_rows_ = std::clamp<Index>(rows > 10 ? (rows - 10) / 4 : 1, 1, height_);
+
+            // mkstemp() picks unused names with O_EXCL, so worlds sharing a directory never touch each other's files.
+            for (int file = 0; file != 2; ++ file) {
+                std::string name = (directory / (file == 0 ? "generation-a-XXXXXX" : "generation-b-XXXXXX")).string();
+                files_[file] = ::mkstemp(name.data());
+                if (files_[file] < 0) {
+                    errors::OUT_OF_CORE_IO error{name};
+                    close_files();
+                    throw error;
+                }
+                paths_[file] = name;
+                // Sparse until written: an all-dead world costs no disk space.
+                if (::ftruncate(files_[file], static_cast<off_t>(height_ * row_bytes())) != 0) {
+                    errors::OUT_OF_CORE_IO error{"ftruncate"};
+                    close_files();
+                    throw error;
+                }
+            }
+            for (auto &band: input_)
+                band.assign((band_rows_ + 1) * words_, 0);
+            for (auto &band: output_)
+                band.assign(band_rows_ * words_, 0);
+            above_.assign(words_, 0);
+            below_.assign(words_, 0);
+            west_.assign(3 * words_, 0);
+            east_.assign(3 * words_, 0);
+        }
+
+        ~OutOfCoreWorld() {
+            close_files();
+        }
+
+        OutOfCoreWorld(const OutOfCoreWorld &) = delete;
+        OutOfCoreWorld &operator = (const OutOfCoreWorld &) = delete;
+
+        Index width() const { return width_; }
+
+        Index height() const { return height_; }
+
+        /// Rows per streamed band.
+        Index band_rows() const { return band_rows_; }
+
+        /// Bytes of the streaming window.
+        Index window_bytes() const {
+            return ((2 * band_rows_ + 1) * 2 + 8) * row_bytes();
+        }
+
+        /// Number of generations performed.
+        Index generation() const { return generation_; }
+
+        /// Alive cells of the current generation.
+        Index population() const { return population_; }
+
+        /// Reads a single cell from the file.
+        CellState get(Index i, Index j) const {
+            Word word;
+            read_at(files_[current_], &word, sizeof(Word), word_offset(i, j));
+            return (word >> (j % WORD_BITS)) & 1u ? CellState::ALIVE : CellState::DEAD;
+        }
+
+        /// Writes a single cell into the file. Keeps the population exact.
+        void set(Index i, Index j, CellState state) {
+            Word word;
+            Index offset = word_offset(i, j);
+            read_at(files_[current_], &word, sizeof(Word), offset);
+            Word bit = Word{1} << (j % WORD_BITS);
+            bool was_alive = (word & bit) != 0;
+            bool alive = state == CellState::ALIVE;
+            if (was_alive == alive)
+                return;
+            word ^= bit;
+            population_ = alive ? population_ + 1 : population_ - 1;
+            write_at(files_[current_], &word, sizeof(Word), offset);
+        }
+
+        /**
+         * Replaces every cell with the soup World::randomize() makes of the whole world for the same arguments.
+         * Streamed band by band.
+         * @throw errors::RANDOM_BAD_DENSITY if @param density is not within [0, 1]
+         */
+        void randomize(double density, std::uint64_t seed) {
+            const random::Density probability{density};
+            metrics::ScopedTimer timer{metrics::Phase::GRID_BUILD};
+            population_ = 0;
+            auto &band = output_[0];
+            for (Index first = 0; first < height_; first += band_rows_) {
+                Index count = std::min(band_rows_, height_ - first);
+                std::fill(band.begin(), band.end(), 0);
+                for (Index r = 0; r != count; ++ r)
+                    for (Index j = 0; j != width_; ++ j)
+                        if (random::cell_alive(seed, j + (first + r) * width_, probability)) {
+                            band[r * words_ + j / WORD_BITS] |= Word{1} << (j % WORD_BITS);
+                            ++ population_;
+                        }
+                write_rows(files_[current_], first, count, band.data());
+            }
+        }
+
+        /// Cells of row @param i, one byte (0 or 1) each.
+        std::vector<std::uint8_t> row_cells(Index i) const {
+            if (i >= height_)
+                throw errors::OUT_OF_CORE_OUT_OF_RANGE();
+            std::vector<Word> words(words_);
+            read_rows(files_[current_], i, 1, words.data());
+            std::vector<std::uint8_t> cells(width_);
+            for (Index j = 0; j != width_; ++ j)
+                cells[j] = (words[j / WORD_BITS] >> (j % WORD_BITS)) & 1u;
+            return cells;
+        }
+
+        /**
+         * Reads @param count packed rows from row @param first straight into caller memory, `(width() + 63) / 64`
+         * words per row, laid out as a PackedRowView with that many words per row.
+         * @throw errors::OUT_OF_CORE_OUT_OF_RANGE if the rows are outside the world
+         * @throw errors::VIEW_EXPORT_TOO_SMALL if @param out can't hold them
+         */
+        PackedRowView export_rows(Index first, Index count, std::span<std::uint64_t> out) const {
+            if (first > height_ || count > height_ - first)
+                throw errors::OUT_OF_CORE_OUT_OF_RANGE();
+            if (out.size() < count * words_)
+                throw errors::VIEW_EXPORT_TOO_SMALL();
+            if (count != 0)
+                read_rows(files_[current_], first, count, out.data());
+            return PackedRowView{out.data(), width_, count, words_};
+        }
+
+        /// Advances the world by one generation.
+        void step() {
+            const int source = files_[current_];
+            const int target = files_[1 - current_];
+            const Index bands = (height_ + band_rows_ - 1) / band_rows_;
+            read_boundary_row(false, above_);
+            read_boundary_row(true, below_);
+
+            // Band k is read with the row below it, unless it is the last band, which takes below_.
+            auto read_band = [this, source, bands](Index band) {
+                Index first = band * band_rows_;
+                Index count = std::min(band_rows_, height_ - first);
+                Word *rows = input_[band % 2].data();
+                read_rows(source, first, band + 1 == bands ? count : count + 1, rows);
+                if (band + 1 == bands)
+                    std::copy(below_.begin(), below_.end(), rows + count * words_);
+            };
+
+            std::future<void> reading = std::async(std::launch::async, read_band, 0);
+            std::array<std::future<void>, 2> writing;
+            Index population = 0;
+            for (Index band = 0; band != bands; ++ band) {
+                Index first = band * band_rows_;
+                Index count = std::min(band_rows_, height_ - first);
+                {
+                    metrics::ScopedTimer timer{metrics::Phase::IO};
+                    reading.get();
+                }
+                if (band + 1 != bands)
+                    reading = std::async(std::launch::async, read_band, band + 1);
+                auto &out = output_[band % 2];
+                if (writing[band % 2].valid()) {
+                    metrics::ScopedTimer timer{metrics::Phase::IO};
+                    writing[band % 2].get();
+                }
+                {
+                    metrics::ScopedTimer timer{metrics::Phase::EXEC};
+                    population += exec_band(above_.data(), input_[band % 2].data(), count, out.data());
+                }
+                const Word *last = input_[band % 2].data() + (count - 1) * words_;
+                std::copy(last, last + words_, above_.begin());
+                writing[band % 2] = std::async(std::launch::async, [this, target, first, count, &out] {
+                    write_rows(target, first, count, out.data());
+                });
+            }
+            {
+                metrics::ScopedTimer timer{metrics::Phase::IO};
+                for (auto &write: writing)
+                    if (write.valid())
+                        write.get();
+            }
+
+            metrics::ScopedTimer timer{metrics::Phase::COMMIT};
+            current_ = 1 - current_;
+            population_ = population;
+            ++ generation_;
+        }
+
+        /// Performs @param generations steps.
+        void run(Index generations) {
+            for (; generations != 0; -- generations)
+                step();
+        }
+    };
+}
+
+#endif //CPP_GAME_OF_DEATH_OUT_OF_CORE_HPP
@@ -0,0 +1,201 @@
+#ifndef CPP_GAME_OF_DEATH_PIPELINE_HPP
+#define CPP_GAME_OF_DEATH_PIPELINE_HPP
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <thread>
+#include <vector>
+
+#include "world.hpp"
+
+namespace engine::errors {
+    struct PIPELINE_BAD_CONFIG : public std::invalid_argument {
+        PIPELINE_BAD_CONFIG() : std::invalid_argument("Pipeline depth and generations per frame must be positive") {};
+    };
+}
+
+namespace engine {
+
+    /// Tunables of the Pipeline.
+    struct PipelineConfig {
+        Index depth{2}; ///< Frames which may be queued or held by consumers at once. Producer waits beyond it.
+        Index generations_per_frame{1}; ///< World::run() argument between two frames.
+        Index frames{0}; ///< Frames to produce, including the initial one. 0 means until the pipeline is destroyed.
+    };
+
+    /// Read-only snapshot of a World generation, owned by the Pipeline's frame pool.
+    class Frame {
+        friend class Pipeline;
+
+        std::vector<std::uint8_t> cells_;
+        GenerationStats stats_;
+        Index width_{};
+        Index height_{};
+
+    public:
+        Index width() const { return width_; }
+
+        Index height() const { return height_; }
+
+        Index generation() const { return stats_.generation; }
+
+        const GenerationStats &stats() const { return stats_; }
+
+        /// Raw states, row by row.
+        std::span<const std::uint8_t> cells() const { return cells_; }
+
+        std::uint8_t state(Index i, Index j) const { return cells_[j + i * width_]; }
+    };
+
+    /// Frame handle. The frame returns to the pool when the last handle is released.
+    using FrameHandle = std::shared_ptr<const Frame>;
+
+    /**
+     * Asynchronous producer of World generations.
+     *
+     * A dedicated thread snapshots the world into a free frame, hands it to the consumers and immediately starts
+     * computing the next generation, so renderers, analyzers and writers overlap with stepping instead of adding to it.
+     * Frames come from a fixed pool of PipelineConfig::depth, so nothing is allocated per generation and the producer
+     * blocks (back-pressure) while all the frames are queued or held.
+     *
+     * The world must not be touched by anyone else until the pipeline is destroyed, except for World::submit().
+     */
+    class Pipeline {
+        /// Shared with the frame handles, so they may outlive the pipeline.
+        struct State {
+            std::mutex mutex;
+            std::condition_variable frame_freed;
+            std::condition_variable frame_ready;
+            std::vector<std::unique_ptr<Frame>> pool;
+            std::vector<Frame *> free;
+            std::deque<Frame *> ready;
+            Index produced{};
+            bool stopping{false};
+            bool finished{false};
+            std::exception_ptr error;
+        };
+
+        World &world_;
+        PipelineConfig config_;
+        std::shared_ptr<State> state_;
+        std::jthread producer_;
+
+        /// Waits for a free frame. @return nullptr when the pipeline is stopping.
+        Frame *acquire() {
+            std::unique_lock lock{state_->mutex};
+            state_->frame_freed.wait(lock, [this] { return state_->stopping || !state_->free.empty(); });
+            if (state_->stopping)
+                return nullptr;
+            auto *frame = state_->free.back();
+            state_->free.pop_back();
+            return frame;
+        }
+
+        void capture(Frame &frame) const {
+            frame.cells_.resize(world_.width() * world_.height());
+            export_cells(world_.view(), frame.cells_);
+            frame.stats_ = world_.stats();
+            frame.width_ = world_.width();
+            frame.height_ = world_.height();
+        }
+
+        void produce() try {
+            for (Index produced = 0; config_.frames == 0 || produced != config_.frames; ++ produced) {
+                if (produced != 0)
+                    world_.run(config_.generations_per_frame);
+                auto *frame = acquire();
+                if (frame == nullptr)
+                    break;
+                capture(*frame);
+                {
+                    std::lock_guard lock{state_->mutex};
+                    state_->ready.push_back(frame);
+                    ++ state_->produced;
+                }
+                state_->frame_ready.notify_one();
+            }
+            finish(nullptr);
+        } catch (...) {
+            finish(std::current_exception());
+        }
+
+        void finish(std::exception_ptr error) {
+            {
+                std::lock_guard lock{state_->mutex};
+                state_->finished = true;
+                state_->error = error;
+            }
+            state_->frame_ready.notify_all();
+        }
+
+    public:
+        /**
+         * Starts producing frames of @param world; the first frame is its current generation.
+         * @throw errors::PIPELINE_BAD_CONFIG on zero depth or generations per frame
+         */
+        explicit Pipeline(World &world, PipelineConfig config = {}) :
+            world_{world},
+            config_{config},
+            state_{std::make_shared<State>()}
+        {
+            if (config.depth == 0 || config.generations_per_frame == 0)
+                throw errors::PIPELINE_BAD_CONFIG();
+            for (Index idx = 0; idx != config.depth; ++ idx) {
+                state_->pool.push_back(std::make_unique<Frame>());
+                state_->free.push_back(state_->pool.back().get());
+            }
+            producer_ = std::jthread{[this] { produce(); }};
+        }
+
+        /// Stops the producer after its current generation.
+        ~Pipeline() {
+            {
+                std::lock_guard lock{state_->mutex};
+                state_->stopping = true;
+            }
+            state_->frame_freed.notify_all();
+        }
+
+        Pipeline(const Pipeline &) = delete;
+        Pipeline &operator = (const Pipeline &) = delete;
+
+        /**
+         * Waits for the next frame.
+         * @return std::nullopt when all PipelineConfig::frames were consumed
+         * @throw whatever stepping the world has thrown
+         */
+        std::optional<FrameHandle> next() {
+            std::unique_lock lock{state_->mutex};
+            state_->frame_ready.wait(lock, [this] { return state_->finished || !state_->ready.empty(); });
+            if (state_->ready.empty()) {
+                if (state_->error)
+                    std::rethrow_exception(state_->error);
+                return std::nullopt;
+            }
+            auto *frame = state_->ready.front();
+            state_->ready.pop_front();
+            return FrameHandle{frame, [state = state_](const Frame *released) {
+                {
+                    std::lock_guard lock{state->mutex};
+                    state->free.push_back(const_cast<Frame *>(released));
+                }
+                state->frame_freed.notify_one();
+            }};
+        }
+
+        /// Frames produced so far.
+        Index produced() const {
+            std::lock_guard lock{state_->mutex};
+            return state_->produced;
+        }
+    };
+}
+
+#endif //CPP_GAME_OF_DEATH_PIPELINE_HPP
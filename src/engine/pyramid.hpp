@@ -0,0 +1,192 @@
+#ifndef CPP_GAME_OF_DEATH_PYRAMID_HPP
+#define CPP_GAME_OF_DEATH_PYRAMID_HPP
+
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+#include "bounding_box.hpp"
+
+namespace engine::errors {
+    struct PYRAMID_OUT_OF_RANGE : public std::out_of_range {
+        PYRAMID_OUT_OF_RANGE() : std::out_of_range("Population pyramid level or block is out of range") {};
+    };
+}
+
+namespace engine {
+
+    /// Populations of the blocks of a PopulationPyramid level covering a queried area, row by row.
+    class Viewport {
+        friend class PopulationPyramid;
+
+        Index level_{};
+        Index block_{};
+        Index width_{};
+        Index height_{};
+        BoundingBox blocks_;
+        std::vector<Index> population_;
+
+    public:
+        Index level() const { return level_; }
+
+        /// Side of a block in cells.
+        Index block() const { return block_; }
+
+        Index rows() const { return blocks_.bottom - blocks_.top; }
+
+        Index cols() const { return blocks_.right - blocks_.left; }
+
+        /// Blocks of the level covered by the viewport.
+        const BoundingBox &blocks() const { return blocks_; }
+
+        /// Cells of block (@param r, @param c) of the viewport, clipped to the world.
+        BoundingBox rect(Index r, Index c) const {
+            Index top = (blocks_.top + r) * block_;
+            Index left = (blocks_.left + c) * block_;
+            return BoundingBox{top, left, std::min(top + block_, height_), std::min(left + block_, width_)};
+        }
+
+        Index population(Index r, Index c) const { return population_[c + r * cols()]; }
+
+        /// Alive cells per cell of the block, in [0, 1].
+        double density(Index r, Index c) const {
+            auto box = rect(r, c);
+            return static_cast<double>(population(r, c)) / ((box.bottom - box.top) * (box.right - box.left));
+        }
+
+        bool any_alive(Index r, Index c) const { return population(r, c) != 0; }
+    };
+
+    /**
+     * Mipmap of alive cell counts.
+     *
+     * Level 0 counts the cells of `block` x `block` squares, every next level sums 2 x 2 blocks of the previous one,
+     * up to a single block covering the world. The owner keeps level 0 up to date and calls refresh() for the blocks
+     * it has changed, so maintaining the pyramid costs time proportional to the changes and viewport() costs time
+     * proportional to its output, whatever the world area.
+     */
+    class PopulationPyramid {
+        struct Level {
+            Index rows{};
+            Index cols{};
+            std::vector<Index> population;
+        };
+
+        Index width_{};
+        Index height_{};
+        Index block_{};
+        std::vector<Level> levels_;
+
+        const Level &level_at(Index level) const {
+            if (level >= levels_.size())
+                throw errors::PYRAMID_OUT_OF_RANGE();
+            return levels_[level];
+        }
+
+    public:
+        /// Empty pyramid without levels.
+        PopulationPyramid() = default;
+
+        /**
+         * All-dead pyramid of a @param width x @param height world.
+         * @param block side of level 0 blocks in cells
+         */
+        PopulationPyramid(Index width, Index height, Index block) : width_{width}, height_{height}, block_{block} {
+            Index rows = (height + block - 1) / block;
+            Index cols = (width + block - 1) / block;
+            while (true) {
+                levels_.push_back(Level{rows, cols, std::vector<Index>(rows * cols, 0)});
+                if (rows == 1 && cols == 1)
+                    break;
+                rows = (rows + 1) / 2;
+                cols = (cols + 1) / 2;
+            }
+        }
+
+        /// Side of level 0 blocks in cells.
+        Index block() const { return block_; }
+
+        /// Number of levels; the last one has a single block.
+        Index levels() const { return levels_.size(); }
+
+        Index level_rows(Index level) const { return level_at(level).rows; }
+
+        Index level_cols(Index level) const { return level_at(level).cols; }
+
+        Index population(Index level, Index r, Index c) const {
+            auto &layer = level_at(level);
+            if (r >= layer.rows || c >= layer.cols)
+                throw errors::PYRAMID_OUT_OF_RANGE();
+            return layer.population[c + r * layer.cols];
+        }
+
+        /**
+         * Sets the population of level 0 block (@param r, @param c) without touching the levels above.
+         * Distinct blocks may be set concurrently; call refresh() afterwards.
+         */
+        void set_block(Index r, Index c, Index population) {
+            levels_[0].population[c + r * levels_[0].cols] = population;
+        }
+
+        /// Adds @param delta to the blocks containing cell (@param i, @param j) on every level.
+        void adjust(Index i, Index j, int delta) {
+            Index r = i / block_;
+            Index c = j / block_;
+            for (auto &layer: levels_) {
+                layer.population[c + r * layer.cols] += static_cast<Index>(delta);
+                r /= 2;
+                c /= 2;
+            }
+        }
+
+        /// Recomputes the levels above 0 over the level 0 @param blocks, after set_block().
+        void refresh(BoundingBox blocks) {
+            for (Index level = 1; level < levels_.size(); ++ level) {
+                auto &below = levels_[level - 1];
+                auto &layer = levels_[level];
+                blocks = BoundingBox{blocks.top / 2, blocks.left / 2, (blocks.bottom + 1) / 2, (blocks.right + 1) / 2};
+                for (Index r = blocks.top; r != blocks.bottom; ++ r)
+                    for (Index c = blocks.left; c != blocks.right; ++ c) {
+                        Index sum = 0;
+                        for (Index br = 2 * r; br != std::min(2 * r + 2, below.rows); ++ br)
+                            for (Index bc = 2 * c; bc != std::min(2 * c + 2, below.cols); ++ bc)
+                                sum += below.population[bc + br * below.cols];
+                        layer.population[c + r * layer.cols] = sum;
+                    }
+            }
+        }
+
+        /**
+         * Blocks of @param level intersecting the cells of @param area.
+         * @throw errors::PYRAMID_OUT_OF_RANGE on a missing level
+         */
+        Viewport viewport(const BoundingBox &area, Index level) const {
+            auto &layer = level_at(level);
+            Viewport view;
+            view.level_ = level;
+            view.block_ = block_ << level;
+            view.width_ = width_;
+            view.height_ = height_;
+            if (area.empty())
+                return view;
+            view.blocks_ = BoundingBox{
+                std::min(area.top / view.block_, layer.rows),
+                std::min(area.left / view.block_, layer.cols),
+                std::min((area.bottom + view.block_ - 1) / view.block_, layer.rows),
+                std::min((area.right + view.block_ - 1) / view.block_, layer.cols)
+            };
+            if (view.blocks_.empty()) {
+                view.blocks_ = BoundingBox{};
+                return view;
+            }
+            view.population_.reserve(view.rows() * view.cols());
+            for (Index r = view.blocks_.top; r != view.blocks_.bottom; ++ r) {
+                auto first = layer.population.begin() + r * layer.cols;
+                view.population_.insert(view.population_.end(), first + view.blocks_.left, first + view.blocks_.right);
+            }
+            return view;
+        }
+    };
+}
+
+#endif //CPP_GAME_OF_DEATH_PYRAMID_HPP
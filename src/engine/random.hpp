@@ -0,0 +1,72 @@
+#ifndef CPP_GAME_OF_DEATH_RANDOM_HPP
+#define CPP_GAME_OF_DEATH_RANDOM_HPP
+
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+
+namespace engine::errors {
+    struct RANDOM_BAD_DENSITY : public std::invalid_argument {
+        RANDOM_BAD_DENSITY() : std::invalid_argument("Random soup density must be within [0, 1]") {};
+    };
+}
+
+/**
+ * Counter-based random soups: the state of a cell is a pure function of (seed, cell index), so soups can be generated
+ * in any order, by any number of threads, and always come out the same.
+ */
+namespace engine::random {
+
+    /// SplitMix64 finalizer: a bijective mix of all 64 bits.
+    constexpr std::uint64_t splitmix64(std::uint64_t x) {
+        x += 0x9E3779B97F4A7C15ull;
+        x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+        x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+        return x ^ (x >> 31);
+    }
+
+    /// Random 64 bits of cell @param index of the soup @param seed.
+    constexpr std::uint64_t cell_bits(std::uint64_t seed, std::uint64_t index) {
+        return splitmix64(splitmix64(seed) ^ index);
+    }
+
+    /**
+     * Seed of stream @param stream (e.g. a world of a batch) of the soup @param seed. Unlike `seed + stream`,
+     * batches of adjacent seeds share no stream.
+     */
+    constexpr std::uint64_t mix(std::uint64_t seed, std::uint64_t stream) {
+        return splitmix64(splitmix64(seed) + stream);
+    }
+
+    /// Probability of a cell being alive, as an inclusive 64-bit threshold of cell_bits().
+    class Density {
+        std::uint64_t threshold_;
+        bool never_;
+
+    public:
+        /// @throw errors::RANDOM_BAD_DENSITY if @param density is not within [0, 1]
+        constexpr explicit Density(double density) :
+            threshold_{},
+            never_{density <= 0}
+        {
+            if (!(density >= 0 && density <= 1))
+                throw errors::RANDOM_BAD_DENSITY();
+            // 2^64 * density, saturated; cells with bits <= threshold are alive.
+            double scaled = density * 18446744073709551616.0;
+            threshold_ = scaled >= 18446744073709551615.0
+                ? std::numeric_limits<std::uint64_t>::max()
+                : static_cast<std::uint64_t>(scaled) - (scaled >= 1);
+        }
+
+        constexpr bool alive(std::uint64_t bits) const {
+            return !never_ && bits <= threshold_;
+        }
+    };
+
+    /// Whether cell @param index of the soup @param seed is alive.
+    constexpr bool cell_alive(std::uint64_t seed, std::uint64_t index, const Density &density) {
+        return density.alive(cell_bits(seed, index));
+    }
+}
+
+#endif //CPP_GAME_OF_DEATH_RANDOM_HPP
@@ -0,0 +1,251 @@
+#ifndef CPP_GAME_OF_DEATH_RULE_HPP
+#define CPP_GAME_OF_DEATH_RULE_HPP
+
+#include <cstdint>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace engine::errors {
+    struct RULE_SYNTAX : public std::invalid_argument {
+        RULE_SYNTAX(std::string_view notation) :
+            std::invalid_argument("Can't parse rule notation '" + std::string(notation) + "'") {};
+    };
+
+    struct TRANSITION_OUT_OF_RANGE : public std::out_of_range {
+        TRANSITION_OUT_OF_RANGE() : std::out_of_range("Transition table needs 2..256 states and results below it") {};
+    };
+}
+
+namespace engine {
+
+    /// Largest neighbor count a rule can react to.
+    constexpr unsigned MAX_NEIGHBORS = 31;
+
+    /**
+     * Life-like (outer totalistic) rule of a binary automaton.
+     * The next state of a cell depends on its own state and on the number of alive neighbors only.
+     * Each mask keeps one bit per possible neighbor count, so neighborhoods of up to 31 nodes are supported.
+     */
+    struct LifeRule {
+        std::uint32_t birth{};   ///< Bit n is set: a dead cell with n alive neighbors becomes alive.
+        std::uint32_t survive{}; ///< Bit n is set: an alive cell with n alive neighbors stays alive.
+
+        /// Next state (0 or 1) of a cell being @param alive and having @param count alive neighbors.
+        constexpr std::uint8_t next(std::uint8_t alive, unsigned count) const {
+            return ((alive ? survive : birth) >> count) & 1u;
+        }
+
+        /// Whether the dead world stays dead. False for "B0" rules.
+        constexpr bool keeps_void() const {
+            return (birth & 1u) == 0;
+        }
+
+        constexpr bool operator == (const LifeRule &) const = default;
+
+        /// The rule implemented by conway::ConwayNodeExecutor ("B3/S23").
+        static constexpr LifeRule conway() {
+            return LifeRule{1u << 3, (1u << 2) | (1u << 3)};
+        }
+
+        /// Bays' 3D rule "4555" for 26 neighbors: survives with 4 or 5 alive neighbors, born with 5 ("B5/S4,5").
+        static constexpr LifeRule bays_4555() {
+            return LifeRule{1u << 5, (1u << 4) | (1u << 5)};
+        }
+
+        /**
+         * Parses the notation of rules with large neighborhoods, where counts may have several digits:
+         * comma separated counts or inclusive ranges, e.g. "B5-7/S4,5,13-15".
+         * @throw errors::RULE_SYNTAX on malformed notation or counts above MAX_NEIGHBORS
+         */
+        static LifeRule parse_counts(std::string_view notation) {
+            LifeRule rule;
+            for (std::string_view rest = notation; !rest.empty(); ) {
+                auto end = rest.find('/');
+                auto part = rest.substr(0, end);
+                rest = end == std::string_view::npos ? std::string_view{} : rest.substr(end + 1);
+                if (part.empty() || (part[0] != 'B' && part[0] != 'b' && part[0] != 'S' && part[0] != 's'))
+                    throw errors::RULE_SYNTAX(notation);
+                std::uint32_t &mask = part[0] == 'B' || part[0] == 'b' ? rule.birth : rule.survive;
+
+                // Counts: number [ '-' number ] separated by ','.
+                unsigned first = 0, current = 0;
+                bool digits = false, range = false;
+                auto flush = [&] {
+                    if (!digits || current > MAX_NEIGHBORS || (range && first > current))
+                        throw errors::RULE_SYNTAX(notation);
+                    for (unsigned count = range ? first : current; count <= current; ++ count)
+                        mask |= 1u << count;
+                    current = 0;
+                    digits = range = false;
+                };
+                for (char c: part.substr(1)) {
+                    if (c >= '0' && c <= '9') {
+                        current = current * 10 + (c - '0');
+                        digits = true;
+                        if (current > MAX_NEIGHBORS)
+                            throw errors::RULE_SYNTAX(notation);
+                    } else if (c == '-' && digits && !range) {
+                        first = current;
+                        current = 0;
+                        digits = false;
+                        range = true;
+                    } else if (c == ',') {
+                        flush();
+                    } else {
+                        throw errors::RULE_SYNTAX(notation);
+                    }
+                }
+                // Any counts end with a number: this rejects a trailing ',' or '-'.
+                if (part.size() > 1)
+                    flush();
+            }
+            return rule;
+        }
+
+        /**
+         * Parses the "B<digits>/S<digits>" notation, e.g. "B36/S23".
+         * @throw errors::RULE_SYNTAX on malformed notation
+         */
+        static LifeRule parse(std::string_view notation) {
+            LifeRule rule;
+            std::uint32_t *mask = nullptr;
+            for (char c: notation) {
+                if (c == 'B' || c == 'b')
+                    mask = &rule.birth;
+                else if (c == 'S' || c == 's')
+                    mask = &rule.survive;
+                else if (c == '/')
+                    mask = nullptr;
+                else if (c >= '0' && c <= '9' && mask != nullptr)
+                    *mask |= 1u << (c - '0');
+                else
+                    throw errors::RULE_SYNTAX(notation);
+            }
+            return rule;
+        }
+    };
+
+    /**
+     * Multi-state rule of the "Generations" family.
+     * State 0 is dead, state 1 is alive (firing), states 2..states-1 are refractory: an alive cell that doesn't survive
+     * starts dying and advances by one state each generation until it is dead again. Only firing neighbors count.
+     */
+    struct GenerationsRule {
+        std::uint32_t birth{}; ///< Bit n is set: a dead cell with n firing neighbors starts firing.
+        std::uint32_t survive{}; ///< Bit n is set: a firing cell with n firing neighbors keeps firing.
+        unsigned states{2}; ///< Number of states including dead and firing ones.
+
+        /// Next state of a cell in @param state having @param firing neighbors.
+        constexpr std::uint8_t next(std::uint8_t state, unsigned firing) const {
+            if (state == 0)
+                return (birth >> firing) & 1u;
+            if (state == 1 && ((survive >> firing) & 1u))
+                return 1;
+            return state + 1u < states ? state + 1u : 0;
+        }
+
+        constexpr bool operator == (const GenerationsRule &) const = default;
+
+        /// "B2/S/C3"
+        static constexpr GenerationsRule brians_brain() {
+            return GenerationsRule{1u << 2, 0, 3};
+        }
+
+        /// "B2/S345/C4"
+        static constexpr GenerationsRule star_wars() {
+            return GenerationsRule{1u << 2, (1u << 3) | (1u << 4) | (1u << 5), 4};
+        }
+
+        /**
+         * Parses the "B<digits>/S<digits>/C<states>" notation, e.g. "B2/S/C3". Without C the rule has 2 states.
+         * @throw errors::RULE_SYNTAX on malformed notation
+         */
+        static GenerationsRule parse(std::string_view notation) {
+            auto split = notation.find_first_of("Cc");
+            if (split == std::string_view::npos)
+                split = notation.size();
+            auto life = LifeRule::parse(notation.substr(0, split));
+            GenerationsRule rule{life.birth, life.survive, 2};
+            if (split == notation.size())
+                return rule;
+
+            unsigned states = 0;
+            auto digits = notation.substr(split + 1);
+            for (char c: digits) {
+                if (c < '0' || c > '9' || states > 256)
+                    throw errors::RULE_SYNTAX(notation);
+                states = states * 10 + (c - '0');
+            }
+            if (digits.empty() || states < 2 || states > 256)
+                throw errors::RULE_SYNTAX(notation);
+            rule.states = states;
+            return rule;
+        }
+    };
+
+    /**
+     * Table-driven totalistic transition function of an automaton with up to 256 states.
+     * The next state depends on the cell's own state and on the number of its firing (state 1) neighbors only.
+     * Binary Life-like and Generations rules convert implicitly; any other N-state rule can be tabulated from a function.
+     */
+    class TransitionTable {
+    public:
+        /// Entries per state: one for every firing neighbor count 0..MAX_NEIGHBORS.
+        static constexpr unsigned STRIDE = MAX_NEIGHBORS + 1;
+
+        /// The only state counted in the neighborhood. For binary rules it is simply "alive".
+        static constexpr std::uint8_t FIRING = 1;
+
+    private:
+        unsigned states_;
+        std::vector<std::uint8_t> next_;
+
+    public:
+        /**
+         * @param states number of states, 2..256
+         * @param transition next state of a cell by its (state, firing neighbor count)
+         * @throw errors::TRANSITION_OUT_OF_RANGE if the number of states or a result is out of range
+         */
+        TransitionTable(unsigned states, const std::function<std::uint8_t(std::uint8_t, unsigned)> &transition) :
+            states_{states}
+        {
+            if (states < 2 || states > 256)
+                throw errors::TRANSITION_OUT_OF_RANGE();
+            next_.reserve(states * STRIDE);
+            for (unsigned state = 0; state != states; ++ state)
+                for (unsigned firing = 0; firing != STRIDE; ++ firing) {
+                    auto next = transition(static_cast<std::uint8_t>(state), firing);
+                    if (next >= states)
+                        throw errors::TRANSITION_OUT_OF_RANGE();
+                    next_.push_back(next);
+                }
+        }
+
+        TransitionTable(const LifeRule &rule) :
+            TransitionTable(2, [rule](std::uint8_t state, unsigned firing) { return rule.next(state, firing); }) {};
+
+        TransitionTable(const GenerationsRule &rule) :
+            TransitionTable(rule.states, [rule](std::uint8_t state, unsigned firing) {
+                return rule.next(state, firing);
+            }) {};
+
+        unsigned states() const { return states_; }
+
+        /// Binary tables allow summing neighbor states instead of comparing them with FIRING.
+        bool is_binary() const { return states_ == 2; }
+
+        std::uint8_t next(std::uint8_t state, unsigned firing) const {
+            return next_[state * STRIDE + firing];
+        }
+
+        /// Raw table: `data()[state * STRIDE + firing]`.
+        const std::uint8_t *data() const { return next_.data(); }
+
+        bool operator == (const TransitionTable &) const = default;
+    };
+}
+
+#endif //CPP_GAME_OF_DEATH_RULE_HPP
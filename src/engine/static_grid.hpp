@@ -0,0 +1,204 @@
+#ifndef CPP_GAME_OF_DEATH_STATIC_GRID_HPP
+#define CPP_GAME_OF_DEATH_STATIC_GRID_HPP
+
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+
+#include "topology/conway_node.hpp"
+#include "cell_view.hpp"
+#include "kernel.hpp"
+#include "random.hpp"
+#include "rule.hpp"
+#include "stencil.hpp"
+
+namespace engine::errors {
+    struct STATIC_GRID_OUT_OF_RANGE : public std::out_of_range {
+        STATIC_GRID_OUT_OF_RANGE() : std::out_of_range("Static grid cell index is out of range") {};
+    };
+
+    struct STATIC_GRID_BAD_PATTERN : public std::invalid_argument {
+        STATIC_GRID_BAD_PATTERN() : std::invalid_argument(
+            "Static grid pattern rows must have the grid width and hold '.' (dead) or 'O' (alive) only"
+        ) {};
+    };
+}
+
+namespace engine {
+    using conway::CellState;
+
+    /**
+     * Binary world whose shape, topology, rule and neighborhood are template arguments, for small grids stepped a
+     * huge number of times (puzzles, fixtures).
+     *
+     * Each row is one 64-bit word, so there is no allocation and no per-cell node. The neighbor rows and the border
+     * bits are resolved by neighbor_index() at compile time and the rows are stepped by an unrolled sequence, with
+     * the bit-sliced kernel of kernel.hpp counting 64 cells at once. Everything is constexpr, so pattern evolutions
+     * can be checked by static_assert.
+     */
+    template<
+        Index Width,
+        Index Height,
+        GridTopology Topology = GridTopology::TORUS,
+        LifeRule Rule = LifeRule::conway(),
+        GridNeighborhood Neighborhood = GridNeighborhood::MOORE
+    >
+    class StaticGrid {
+        static_assert(Width > 0 && Width <= 64, "Static grid rows are single 64-bit words");
+        static_assert(Height > 0);
+        static_assert(((Rule.birth | Rule.survive) >> (stencil(Neighborhood).size() + 1)) == 0,
+                      "Rule counts exceed the neighborhood size");
+
+        using Word = std::uint64_t;
+        using Rows = std::array<Word, Height>;
+
+        static constexpr Word MASK = Width == 64 ? ~Word{0} : (Word{1} << Width) - 1;
+        static constexpr bool MOORE = Neighborhood == GridNeighborhood::MOORE;
+
+        /// Row above (@param di = -1) or below (+1) every row, std::nullopt outside a RAW grid.
+        static constexpr std::array<std::optional<Index>, Height> neighbor_rows(int di) {
+            std::array<std::optional<Index>, Height> rows{};
+            for (Index i = 0; i != Height; ++ i)
+                rows[i] = neighbor_index(i, 0, {di, 0}, 1, Height, Topology);
+            return rows;
+        }
+
+        static constexpr auto ABOVE = neighbor_rows(-1);
+        static constexpr auto BELOW = neighbor_rows(1);
+        /// Columns seen west of column 0 and east of the last one.
+        static constexpr auto WEST_EDGE = neighbor_index(0, 0, {0, -1}, Width, 1, Topology);
+        static constexpr auto EAST_EDGE = neighbor_index(0, Width - 1, {0, 1}, Width, 1, Topology);
+
+        Rows rows_{};
+        Index generation_{};
+
+        static constexpr Word west_of(Word row) {
+            Word edge = WEST_EDGE ? (row >> *WEST_EDGE) & 1u : 0;
+            return ((row << 1) | edge) & MASK;
+        }
+
+        static constexpr Word east_of(Word row) {
+            Word edge = EAST_EDGE ? (row >> *EAST_EDGE) & 1u : 0;
+            return (row >> 1) | (edge << (Width - 1));
+        }
+
+        template<Index I>
+        constexpr Word next_row() const {
+            constexpr auto above = ABOVE[I];
+            constexpr auto below = BELOW[I];
+            const Word up = above ? rows_[*above] : 0;
+            const Word down = below ? rows_[*below] : 0;
+            const Word mid = rows_[I];
+            BitCounts counts{};
+            add_bits(counts, up);
+            add_bits(counts, down);
+            add_bits(counts, west_of(mid));
+            add_bits(counts, east_of(mid));
+            if constexpr (MOORE) {
+                add_bits(counts, west_of(up));
+                add_bits(counts, east_of(up));
+                add_bits(counts, west_of(down));
+                add_bits(counts, east_of(down));
+            }
+            return next_bits(Rule, mid, counts) & MASK;
+        }
+
+        static constexpr void check(Index i, Index j) {
+            if (i >= Height || j >= Width)
+                throw errors::STATIC_GRID_OUT_OF_RANGE();
+        }
+
+    public:
+        static constexpr Index WIDTH = Width;
+        static constexpr Index HEIGHT = Height;
+
+        /// All-dead grid.
+        constexpr StaticGrid() = default;
+
+        /**
+         * Grid drawn by @param pattern, one string per row: '.' is a dead cell, 'O' an alive one.
+         * @throw errors::STATIC_GRID_BAD_PATTERN on other characters or rows of another width
+         */
+        explicit constexpr StaticGrid(const std::array<std::string_view, Height> &pattern) {
+            for (Index i = 0; i != Height; ++ i) {
+                if (pattern[i].size() != Width)
+                    throw errors::STATIC_GRID_BAD_PATTERN();
+                for (Index j = 0; j != Width; ++ j) {
+                    if (pattern[i][j] != '.' && pattern[i][j] != 'O')
+                        throw errors::STATIC_GRID_BAD_PATTERN();
+                    rows_[i] |= Word{pattern[i][j] == 'O'} << j;
+                }
+            }
+        }
+
+        /// Number of generations performed.
+        constexpr Index generation() const { return generation_; }
+
+        constexpr CellState get(Index i, Index j) const {
+            check(i, j);
+            return (rows_[i] >> j) & 1u ? CellState::ALIVE : CellState::DEAD;
+        }
+
+        constexpr void set(Index i, Index j, CellState state) {
+            check(i, j);
+            if (state == CellState::ALIVE)
+                rows_[i] |= Word{1} << j;
+            else
+                rows_[i] &= ~(Word{1} << j);
+        }
+
+        /// Alive cells.
+        constexpr Index population() const {
+            Index population = 0;
+            for (Word row: rows_)
+                population += std::popcount(row);
+            return population;
+        }
+
+        /// Rows as words, bit j being column j.
+        constexpr const Rows &rows() const { return rows_; }
+
+        /// The rows as a packed view, valid until the grid is changed.
+        PackedRowView view() const {
+            return PackedRowView{rows_.data(), Width, Height, 1};
+        }
+
+        /**
+         * Replaces every cell with the soup World::randomize() makes of the whole world for the same arguments.
+         * @throw errors::RANDOM_BAD_DENSITY if @param density is not within [0, 1]
+         */
+        constexpr void randomize(double density, std::uint64_t seed) {
+            const random::Density probability{density};
+            for (Index i = 0; i != Height; ++ i) {
+                rows_[i] = 0;
+                for (Index j = 0; j != Width; ++ j)
+                    rows_[i] |= Word{random::cell_alive(seed, j + i * Width, probability)} << j;
+            }
+        }
+
+        /// Advances the grid by one generation.
+        constexpr void step() {
+            [this]<Index... I>(std::integer_sequence<Index, I...>) {
+                rows_ = Rows{next_row<I>()...};
+            }(std::make_integer_sequence<Index, Height>{});
+            ++ generation_;
+        }
+
+        /// Performs @param generations steps.
+        constexpr void run(Index generations) {
+            for (; generations != 0; -- generations)
+                step();
+        }
+
+        /// Same cells, whatever the generations performed.
+        constexpr bool operator == (const StaticGrid &other) const {
+            return rows_ == other.rows_;
+        }
+    };
+}
+
+#endif //CPP_GAME_OF_DEATH_STATIC_GRID_HPP
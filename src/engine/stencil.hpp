@@ -0,0 +1,68 @@
+#ifndef CPP_GAME_OF_DEATH_STENCIL_HPP
+#define CPP_GAME_OF_DEATH_STENCIL_HPP
+
+#include <array>
+#include <cstddef>
+#include <optional>
+#include <span>
+
+#include "topology/grid.hpp"
+
+namespace engine {
+    using topology::Index;
+    using topology::grid::GridTopology;
+    using topology::grid::GridNeighborhood;
+
+    /// Relative position of a neighbor.
+    struct Offset {
+        int di; ///< Row shift.
+        int dj; ///< Column shift.
+    };
+
+    /// Same neighbors (and in the same order) as make_grid() subscribes for GridNeighborhood::VON_NEUMANN.
+    constexpr std::array<Offset, 4> VON_NEUMANN_OFFSETS{{{-1, 0}, {1, 0}, {0, -1}, {0, 1}}};
+
+    /// Same neighbors (and in the same order) as make_grid() subscribes for GridNeighborhood::MOORE.
+    constexpr std::array<Offset, 8> MOORE_OFFSETS{{
+        {-1, 0}, {1, 0}, {0, -1}, {0, 1},
+        {-1, -1}, {-1, 1}, {1, -1}, {1, 1}
+    }};
+
+    /// Neighbor offsets of the given @param neighborhood.
+    constexpr std::span<const Offset> stencil(GridNeighborhood neighborhood) {
+        if (neighborhood == GridNeighborhood::MOORE)
+            return MOORE_OFFSETS;
+        return VON_NEUMANN_OFFSETS;
+    }
+
+    /**
+     * Linear index of the cell at (@param i + @param di, @param j + @param dj) in the given topology.
+     * Mirrors topology::grid::assets::get_node_if_exists() for flat cell buffers.
+     * @return std::nullopt if there is no such cell (outside the RAW grid)
+     */
+    constexpr std::optional<Index> neighbor_index(
+            Index i,
+            Index j,
+            Offset offset,
+            Index width,
+            Index height,
+            GridTopology topology
+    ) {
+        auto ni = static_cast<std::ptrdiff_t>(i) + offset.di;
+        auto nj = static_cast<std::ptrdiff_t>(j) + offset.dj;
+        auto h = static_cast<std::ptrdiff_t>(height);
+        auto w = static_cast<std::ptrdiff_t>(width);
+        if (topology == GridTopology::TORUS) {
+            ni = (ni % h + h) % h;
+            nj = (nj % w + w) % w;
+        } else if (topology == GridTopology::REFLECT) {
+            ni = topology::grid::assets::reflect(ni, h);
+            nj = topology::grid::assets::reflect(nj, w);
+        } else if (ni < 0 || ni >= h || nj < 0 || nj >= w) {
+            return std::nullopt;
+        }
+        return static_cast<Index>(nj + ni * w);
+    }
+}
+
+#endif //CPP_GAME_OF_DEATH_STENCIL_HPP
@@ -0,0 +1,334 @@
+#ifndef CPP_GAME_OF_DEATH_DIFFERENTIAL_HPP
+#define CPP_GAME_OF_DEATH_DIFFERENTIAL_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "engine/block_lut.hpp"
+#include "engine/ensemble.hpp"
+#include "engine/random.hpp"
+#include "engine/world.hpp"
+#include "reference_grid.hpp"
+
+/**
+ * Differential testing of the optimized engines against the ConwayNodeExecutor node graph.
+ *
+ * A Scenario is an initial generation on a grid shape. The reference is stepped generation by generation and every
+ * Engine has to reproduce each of its generations exactly. On divergence the initial alive cells are minimized
+ * (cells are dropped in halving chunks while the engine still diverges), so the report is a small repro.
+ */
+namespace differential {
+    using engine::Index;
+    using engine::GridTopology;
+    using engine::GridNeighborhood;
+    using Clock = std::chrono::steady_clock;
+
+    /// Initial generation of a grid shape; @param cells holds 0 or 1 row by row.
+    struct Scenario {
+        std::string name;
+        Index width{};
+        Index height{};
+        GridTopology topology{GridTopology::RAW};
+        GridNeighborhood neighborhood{GridNeighborhood::VON_NEUMANN};
+        std::vector<std::uint8_t> cells;
+
+        bool alive(Index i, Index j) const { return cells[j + i * width] != 0; }
+    };
+
+    /// Adapter of an engine under test.
+    class Engine {
+    public:
+        virtual ~Engine() = default;
+
+        virtual std::string name() const = 0;
+
+        /// Generations advanced by one step().
+        virtual Index generations() const { return 1; }
+
+        /// Worlds advanced by one step(), against a single one for the reference: speedups are per world.
+        virtual Index worlds() const { return 1; }
+
+        /// Builds the engine for the shape of @param scenario and loads its cells.
+        virtual void load(const Scenario &scenario) = 0;
+
+        virtual void step() = 0;
+
+        virtual bool alive(Index i, Index j) const = 0;
+    };
+
+    /// First cell, row by row, of the first generation an engine got wrong.
+    struct Divergence {
+        Index generation{};
+        Index i{};
+        Index j{};
+        bool expected{}; ///< Reference state of the cell.
+        Scenario minimized; ///< Smallest initial generation found that still diverges.
+    };
+
+    /// Every generation of the reference from a scenario, with the time spent stepping it.
+    struct Trajectory {
+        std::vector<std::vector<std::uint8_t>> generations;
+        Clock::duration time{};
+    };
+
+    /// Outcome of an engine on a scenario.
+    struct Outcome {
+        std::optional<Divergence> divergence;
+        Clock::duration time{}; ///< Spent stepping the engine.
+    };
+
+    /// The reference node graph behind the Engine interface.
+    class ReferenceEngine : public Engine {
+        std::unique_ptr<ReferenceGrid> grid_;
+
+    public:
+        std::string name() const override { return "reference"; }
+
+        void load(const Scenario &scenario) override {
+            grid_ = std::make_unique<ReferenceGrid>(
+                scenario.width, scenario.height, scenario.topology, scenario.neighborhood
+            );
+            for (Index i = 0; i != scenario.height; ++ i)
+                for (Index j = 0; j != scenario.width; ++ j)
+                    if (scenario.alive(i, j))
+                        grid_->set(i, j, conway::CellState::ALIVE);
+        }
+
+        void step() override { grid_->step(); }
+
+        bool alive(Index i, Index j) const override { return grid_->get(i, j) == conway::CellState::ALIVE; }
+    };
+
+    /// World with the given tunables; with a temporal depth above 1 it is compared every depth generations.
+    class WorldEngine : public Engine {
+        std::string name_;
+        engine::WorldConfig config_;
+        std::unique_ptr<engine::World> world_;
+
+    public:
+        WorldEngine(std::string name, engine::WorldConfig config) : name_{std::move(name)}, config_{config} {};
+
+        std::string name() const override { return name_; }
+
+        Index generations() const override { return std::max<Index>(config_.temporal_depth, 1); }
+
+        void load(const Scenario &scenario) override {
+            world_ = std::make_unique<engine::World>(
+                scenario.width, scenario.height, engine::LifeRule::conway(),
+                scenario.topology, scenario.neighborhood, config_
+            );
+            for (Index i = 0; i != scenario.height; ++ i)
+                for (Index j = 0; j != scenario.width; ++ j)
+                    if (scenario.alive(i, j))
+                        world_->set(i, j, conway::CellState::ALIVE);
+        }
+
+        void step() override { world_->step_blocked(generations()); }
+
+        bool alive(Index i, Index j) const override { return world_->get(i, j) == conway::CellState::ALIVE; }
+    };
+
+    /// Ensemble holding the scenario in one lane of a block whose other lanes hold its complement.
+    class EnsembleEngine : public Engine {
+        Index worlds_;
+        Index lane_;
+        std::unique_ptr<engine::Ensemble> ensemble_;
+
+    public:
+        /// @param lane world of @param worlds compared with the reference
+        EnsembleEngine(Index worlds, Index lane) : worlds_{worlds}, lane_{lane} {};
+
+        std::string name() const override { return "ensemble-" + std::to_string(worlds_) + "@" + std::to_string(lane_); }
+
+        void load(const Scenario &scenario) override {
+            ensemble_ = std::make_unique<engine::Ensemble>(
+                scenario.width, scenario.height, worlds_, engine::LifeRule::conway(),
+                scenario.topology, scenario.neighborhood
+            );
+            for (Index world = 0; world != worlds_; ++ world)
+                for (Index i = 0; i != scenario.height; ++ i)
+                    for (Index j = 0; j != scenario.width; ++ j)
+                        if (scenario.alive(i, j) == (world == lane_))
+                            ensemble_->set(world, i, j, conway::CellState::ALIVE);
+        }
+
+        Index worlds() const override { return worlds_; }
+
+        void step() override { ensemble_->step(); }
+
+        bool alive(Index i, Index j) const override {
+            return ensemble_->get(lane_, i, j) == conway::CellState::ALIVE;
+        }
+    };
+
+    /// BlockLutWorld stepping 2 x 2 blocks through the 4 x 4 window table of the rule.
+    class BlockLutEngine : public Engine {
+        Index threads_;
+        std::unique_ptr<engine::BlockLutWorld> world_;
+
+    public:
+        explicit BlockLutEngine(Index threads = 1) : threads_{threads} {};
+
+        std::string name() const override { return "block-lut-" + std::to_string(threads_) + "t"; }
+
+        void load(const Scenario &scenario) override {
+            world_ = std::make_unique<engine::BlockLutWorld>(
+                scenario.width, scenario.height, engine::LifeRule::conway(),
+                scenario.topology, scenario.neighborhood, threads_
+            );
+            for (Index i = 0; i != scenario.height; ++ i)
+                for (Index j = 0; j != scenario.width; ++ j)
+                    if (scenario.alive(i, j))
+                        world_->set(i, j, conway::CellState::ALIVE);
+        }
+
+        void step() override { world_->step(); }
+
+        bool alive(Index i, Index j) const override { return world_->get(i, j) == conway::CellState::ALIVE; }
+    };
+
+    /// Node graph stepped by a grid::Stepper, executing the nodes in batches per executor type.
+    class StepperEngine : public Engine {
+        std::unique_ptr<ReferenceGrid> grid_;
+        std::unique_ptr<topology::grid::Stepper<conway::ConwayNode>> stepper_;
+
+    public:
+        std::string name() const override { return "node-stepper"; }
+
+        void load(const Scenario &scenario) override {
+            grid_ = std::make_unique<ReferenceGrid>(
+                scenario.width, scenario.height, scenario.topology, scenario.neighborhood
+            );
+            for (Index i = 0; i != scenario.height; ++ i)
+                for (Index j = 0; j != scenario.width; ++ j)
+                    if (scenario.alive(i, j))
+                        grid_->set(i, j, conway::CellState::ALIVE);
+            stepper_ = std::make_unique<topology::grid::Stepper<conway::ConwayNode>>(grid_->grid);
+        }
+
+        void step() override { stepper_->step(); }
+
+        bool alive(Index i, Index j) const override { return grid_->get(i, j) == conway::CellState::ALIVE; }
+    };
+
+    /// Steps the reference from @param scenario for @param generations and records them.
+    inline Trajectory trace(const Scenario &scenario, Index generations) {
+        Trajectory trajectory;
+        ReferenceEngine reference;
+        reference.load(scenario);
+        trajectory.generations.push_back(scenario.cells);
+        for (Index generation = 0; generation != generations; ++ generation) {
+            auto start = Clock::now();
+            reference.step();
+            trajectory.time += Clock::now() - start;
+            auto &cells = trajectory.generations.emplace_back(scenario.cells.size());
+            for (Index i = 0; i != scenario.height; ++ i)
+                for (Index j = 0; j != scenario.width; ++ j)
+                    cells[j + i * scenario.width] = reference.alive(i, j);
+        }
+        return trajectory;
+    }
+
+    /**
+     * Steps @param engine from @param scenario along the reference @param trajectory and compares every generation
+     * the engine produces, as long as whole engine steps fit into the trajectory.
+     * @return first divergence, not minimized
+     */
+    inline Outcome compare(Engine &engine, const Scenario &scenario, const Trajectory &trajectory) {
+        Outcome outcome;
+        engine.load(scenario);
+        const Index stride = engine.generations();
+        for (Index generation = stride; generation < trajectory.generations.size(); generation += stride) {
+            auto start = Clock::now();
+            engine.step();
+            outcome.time += Clock::now() - start;
+
+            auto &expected = trajectory.generations[generation];
+            for (Index i = 0; i != scenario.height; ++ i)
+                for (Index j = 0; j != scenario.width; ++ j)
+                    if ((expected[j + i * scenario.width] != 0) != engine.alive(i, j)) {
+                        outcome.divergence = Divergence{generation, i, j, !engine.alive(i, j), scenario};
+                        return outcome;
+                    }
+        }
+        return outcome;
+    }
+
+    /// Drops alive cells of @param divergence's scenario while @param engine still diverges within its generation.
+    inline void minimize(Engine &engine, Divergence &divergence) {
+        Scenario &scenario = divergence.minimized;
+        std::vector<Index> alive;
+        for (Index idx = 0; idx != scenario.cells.size(); ++ idx)
+            if (scenario.cells[idx])
+                alive.push_back(idx);
+
+        for (Index chunk = (alive.size() + 1) / 2; chunk != 0; chunk /= 2)
+            for (Index start = 0; start < alive.size(); ) {
+                Index last = std::min(start + chunk, alive.size());
+                Scenario candidate = scenario;
+                for (Index n = start; n != last; ++ n)
+                    candidate.cells[alive[n]] = 0;
+                auto outcome = compare(engine, candidate, trace(candidate, divergence.generation));
+                if (!outcome.divergence) {
+                    start = last;
+                    continue;
+                }
+                scenario = std::move(candidate);
+                alive.erase(alive.begin() + start, alive.begin() + last);
+                divergence.generation = outcome.divergence->generation;
+                divergence.i = outcome.divergence->i;
+                divergence.j = outcome.divergence->j;
+                divergence.expected = outcome.divergence->expected;
+            }
+    }
+
+    /// Random soup of @param density alive cells, see engine::random.
+    inline Scenario soup(
+        Index width, Index height, GridTopology topology, GridNeighborhood neighborhood, double density,
+        std::uint64_t seed
+    ) {
+        Scenario scenario{
+            "soup-" + std::to_string(seed), width, height, topology, neighborhood,
+            std::vector<std::uint8_t>(width * height, 0)
+        };
+        const engine::random::Density probability{density};
+        for (Index idx = 0; idx != scenario.cells.size(); ++ idx)
+            scenario.cells[idx] = engine::random::cell_alive(seed, idx, probability);
+        return scenario;
+    }
+
+    /// Well-known pattern given as rows of '.' and 'O', centered and clipped to the grid.
+    inline Scenario pattern(
+        std::string name, const std::vector<std::string> &rows, Index width, Index height, GridTopology topology,
+        GridNeighborhood neighborhood
+    ) {
+        Scenario scenario{
+            std::move(name), width, height, topology, neighborhood, std::vector<std::uint8_t>(width * height, 0)
+        };
+        Index top = height > rows.size() ? (height - rows.size()) / 2 : 0;
+        for (Index r = 0; r != rows.size() && top + r < height; ++ r) {
+            Index left = width > rows[r].size() ? (width - rows[r].size()) / 2 : 0;
+            for (Index c = 0; c != rows[r].size() && left + c < width; ++ c)
+                scenario.cells[left + c + (top + r) * width] = rows[r][c] == 'O';
+        }
+        return scenario;
+    }
+
+    /// Glider, blinker, block, R-pentomino and lightweight spaceship.
+    inline std::vector<Scenario> patterns(Index width, Index height, GridTopology topology, GridNeighborhood neighborhood) {
+        return {
+            pattern("glider", {".O.", "..O", "OOO"}, width, height, topology, neighborhood),
+            pattern("blinker", {"OOO"}, width, height, topology, neighborhood),
+            pattern("block", {"OO", "OO"}, width, height, topology, neighborhood),
+            pattern("r-pentomino", {".OO", "OO.", ".O."}, width, height, topology, neighborhood),
+            pattern("lwss", {".O..O", "O....", "O...O", "OOOO."}, width, height, topology, neighborhood)
+        };
+    }
+}
+
+#endif //CPP_GAME_OF_DEATH_DIFFERENTIAL_HPP
@@ -0,0 +1,55 @@
+#ifndef CPP_GAME_OF_DEATH_REFERENCE_GRID_HPP
+#define CPP_GAME_OF_DEATH_REFERENCE_GRID_HPP
+
+#include <cstdint>
+
+#include "topology/conway_node.hpp"
+#include "topology/grid.hpp"
+
+/// Conway node graph built by make_grid(). The ground truth optimized engines are tested against.
+struct ReferenceGrid {
+    using Index = topology::Index;
+    using GridTopology = topology::grid::GridTopology;
+    using GridNeighborhood = topology::grid::GridNeighborhood;
+
+    Index width;
+    Index height;
+    topology::grid::Grid<conway::ConwayNode> grid;
+
+    ReferenceGrid(
+        Index width,
+        Index height,
+        GridTopology topology = GridTopology::RAW,
+        GridNeighborhood neighborhood = GridNeighborhood::VON_NEUMANN
+    ) :
+        width{width},
+        height{height},
+        grid{topology::grid::make_grid<conway::ConwayNode, conway::ConwayNodeExecutor>(
+            width, height, nullptr, topology, neighborhood
+        )} {};
+
+    conway::CellState get(Index i, Index j) {
+        return grid[topology::grid::assets::ij_2_idx(i, j, width)]->value()->get();
+    }
+
+    void set(Index i, Index j, conway::CellState state) {
+        auto *value = grid[topology::grid::assets::ij_2_idx(i, j, width)]->value();
+        value->stage(state);
+        value->commit();
+    }
+
+    void step() {
+        topology::grid::step(grid);
+    }
+};
+
+/// Deterministic pseudo-random soup used to seed the tests: about a third of the cells are alive.
+inline bool soup_cell(std::uint64_t seed, std::uint64_t idx) {
+    std::uint64_t x = seed * 0x9E3779B97F4A7C15ull + idx;
+    x ^= x >> 31;
+    x *= 0xBF58476D1CE4E5B9ull;
+    x ^= x >> 29;
+    return x % 3 == 0;
+}
+
+#endif //CPP_GAME_OF_DEATH_REFERENCE_GRID_HPP
@@ -0,0 +1,84 @@
+#ifndef CPP_GAME_OF_DEATH_TEST_AUTOTUNE_HPP
+#define CPP_GAME_OF_DEATH_TEST_AUTOTUNE_HPP
+
+#include <cassert>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+
+#include "engine/autotune.hpp"
+#include "engine/block_lut.hpp"
+#include "engine/world.hpp"
+
+/// The first tune() benchmarks and persists, the next ones (even of another tuner) read the cache.
+void test_autotune_cache() {
+    using namespace engine;
+
+    auto cache = std::filesystem::temp_directory_path() / "cpp_game_of_death_test" / "autotune.tsv";
+    std::filesystem::remove(cache);
+    {
+        Autotuner tuner{cache, std::chrono::milliseconds{40}};
+        auto tuning = tuner.tune(60, 40);
+        assert(tuning.measured && tuning.cell_ns > 0);
+        assert(!tuner.tune(64, 33).measured);
+    }
+    // A corrupt line is skipped, the good one is kept.
+    std::ofstream{cache, std::ios::app} << "garbage\t1 2\n";
+
+    Autotuner tuner{cache, std::chrono::milliseconds{40}};
+    auto cached = tuner.tune(50, 63);
+    assert(!cached.measured);
+    assert(Autotuner::shape_class(50, 63, LifeRule::conway(), GridTopology::TORUS, GridNeighborhood::MOORE) ==
+           "64x64 torus moore binary");
+    // A tuning of another topology is not reused.
+    assert(tuner.tune(50, 63, LifeRule::conway(), GridTopology::RAW).measured);
+    auto multistate = tuner.tune(50, 63, GenerationsRule::brians_brain());
+    assert(multistate.measured && multistate.engine == TunedEngine::WORLD);
+
+    // The tuned configuration steps like the default one.
+    World plain{50, 63, LifeRule::conway(), GridTopology::TORUS, GridNeighborhood::MOORE};
+    plain.randomize(BoundingBox{0, 0, 63, 50}, 0.3, 8);
+    plain.run(8);
+    if (cached.engine == TunedEngine::BLOCK_LUT) {
+        BlockLutWorld tuned{
+            50, 63, LifeRule::conway(), GridTopology::TORUS, GridNeighborhood::MOORE, cached.config.threads
+        };
+        tuned.randomize(0.3, 8);
+        tuned.run(8);
+        for (Index i = 0; i != 63; ++ i)
+            for (Index j = 0; j != 50; ++ j)
+                assert(tuned.get(i, j) == plain.get(i, j));
+    } else {
+        World tuned{50, 63, LifeRule::conway(), GridTopology::TORUS, GridNeighborhood::MOORE, cached.config};
+        tuned.randomize(BoundingBox{0, 0, 63, 50}, 0.3, 8);
+        tuned.run(8);
+        for (Index i = 0; i != 63; ++ i)
+            for (Index j = 0; j != 50; ++ j)
+                assert(tuned.state(i, j) == plain.state(i, j));
+    }
+    std::filesystem::remove_all(cache.parent_path());
+}
+
+void test_autotune() {
+    using namespace engine;
+
+    Index block_lut = 0;
+    for (auto &candidate: Autotuner::candidates(100, 30)) {
+        assert(candidate.config.threads != 0);
+        if (candidate.engine == TunedEngine::WORLD)
+            assert(candidate.config.tile_width <= 100 && candidate.config.tile_height <= 30);
+        block_lut += candidate.engine == TunedEngine::BLOCK_LUT;
+    }
+    assert(block_lut != 0);
+    for (auto &candidate: Autotuner::candidates(100, 30, false))
+        assert(candidate.engine == TunedEngine::WORLD);
+    Index strips = 0;
+    for (auto &candidate: Autotuner::candidates(100, 3, false)) {
+        assert(candidate.config.tile_height <= 3);
+        ++ strips;
+    }
+    assert(strips != 0);
+    test_autotune_cache();
+}
+
+#endif //CPP_GAME_OF_DEATH_TEST_AUTOTUNE_HPP
@@ -0,0 +1,84 @@
+#ifndef CPP_GAME_OF_DEATH_TEST_BLOCK_LUT_HPP
+#define CPP_GAME_OF_DEATH_TEST_BLOCK_LUT_HPP
+
+#include <cassert>
+
+#include "engine/block_lut.hpp"
+#include "engine/world.hpp"
+
+/// Stepping by 2 x 2 blocks must match World, including the phantom row and column of odd sizes.
+void test_block_lut_matches_world(
+    engine::LifeRule rule,
+    engine::GridTopology topology,
+    engine::GridNeighborhood neighborhood,
+    engine::Index width,
+    engine::Index height,
+    engine::Index threads
+) {
+    using namespace engine;
+
+    BlockLutWorld blocks{width, height, rule, topology, neighborhood, threads};
+    World world{width, height, rule, topology, neighborhood};
+    blocks.randomize(0.4, 17);
+    world.randomize(BoundingBox{0, 0, height, width}, 0.4, 17);
+    for (Index generation = 0; generation != 8; ++ generation) {
+        assert(blocks.population() == world.stats().population && blocks.generation() == generation);
+        auto view = blocks.view();
+        for (Index i = 0; i != height; ++ i) {
+            for (Index j = 0; j != width; ++ j) {
+                assert(blocks.get(i, j) == world.get(i, j));
+                assert(view.alive(i, j) == (world.get(i, j) == CellState::ALIVE));
+            }
+            // Bits past the width stay clear between steps.
+            assert(view.row(i).back() >> 1 >> ((width - 1) % 64) == 0);
+        }
+        blocks.step();
+        world.step();
+    }
+}
+
+/// Tables are shared per rule and neighborhood; edits keep the population.
+void test_block_lut_table() {
+    using namespace engine;
+
+    auto conway = block_table(LifeRule::conway(), GridNeighborhood::MOORE);
+    assert(conway == block_table(LifeRule::parse("B3/S23"), GridNeighborhood::MOORE));
+    assert(conway != block_table(LifeRule::conway(), GridNeighborhood::VON_NEUMANN));
+    // Cells 0 to 2 of row 1 alive: cell (1, 1) survives with 2 neighbors, (2, 1) is born with 3, the others don't.
+    assert((*conway)[0b0000'0000'0111'0000] == 0b0101);
+    assert((*conway)[0b0000'0000'0010'0000] == 0);
+
+    BlockLutWorld world{6, 5, LifeRule::conway(), GridTopology::TORUS, GridNeighborhood::MOORE};
+    world.set(2, 1, CellState::ALIVE);
+    world.set(2, 2, CellState::ALIVE);
+    world.set(2, 3, CellState::ALIVE);
+    world.set(2, 3, CellState::ALIVE);
+    assert(world.population() == 3);
+    world.step();
+    assert(world.population() == 3 && world.get(1, 2) == CellState::ALIVE && world.get(2, 1) == CellState::DEAD);
+
+    bool thrown = false;
+    try {
+        BlockLutWorld{4, 4, GenerationsRule::brians_brain()};
+    } catch (engine::errors::BLOCK_LUT_BAD_CONFIG &) {
+        thrown = true;
+    }
+    assert(thrown);
+}
+
+void test_block_lut() {
+    using namespace engine;
+
+    for (auto topology: {GridTopology::RAW, GridTopology::TORUS, GridTopology::REFLECT})
+        for (auto neighborhood: {GridNeighborhood::VON_NEUMANN, GridNeighborhood::MOORE}) {
+            auto other = LifeRule::parse(neighborhood == GridNeighborhood::MOORE ? "B36/S23" : "B13/S2");
+            for (auto [width, height]: {std::pair<Index, Index>{1, 1}, {5, 3}, {64, 8}, {65, 7}, {130, 4}}) {
+                test_block_lut_matches_world(LifeRule::conway(), topology, neighborhood, width, height, 1);
+                test_block_lut_matches_world(other, topology, neighborhood, width, height, 2);
+            }
+        }
+    test_block_lut_matches_world(LifeRule::conway(), GridTopology::TORUS, GridNeighborhood::MOORE, 200, 61, 4);
+    test_block_lut_table();
+}
+
+#endif //CPP_GAME_OF_DEATH_TEST_BLOCK_LUT_HPP
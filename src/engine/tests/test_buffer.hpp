@@ -0,0 +1,63 @@
+#ifndef CPP_GAME_OF_DEATH_TEST_BUFFER_HPP
+#define CPP_GAME_OF_DEATH_TEST_BUFFER_HPP
+
+#include <cassert>
+#include <cstdint>
+
+#include "engine/buffer.hpp"
+#include "engine/world.hpp"
+#include "reference_grid.hpp"
+#include "test_world.hpp"
+
+void test_buffer_layout() {
+    using namespace engine;
+
+    static_assert(row_stride(1) == CACHE_LINE);
+    static_assert(row_stride(64) == 64);
+    static_assert(row_stride(65) == 128);
+    static_assert(row_stride(4096) == 4096 + CACHE_LINE);
+
+    for (Index size: {Index{1}, Index{1000}, HUGE_PAGE + 1}) {
+        CellBuffer buffer{size, true};
+        assert(reinterpret_cast<std::uintptr_t>(buffer.data()) % CACHE_LINE == 0);
+        assert(buffer.size() == size);
+        buffer[0] = 1;
+        buffer[size - 1] = 2;
+
+        CellBuffer moved{std::move(buffer)};
+        assert(buffer.data() == nullptr);
+        assert(moved[size - 1] == 2 && (size == 1 || moved[0] == 1));
+        if (size < HUGE_PAGE)
+            assert(moved.pages() == PageKind::REGULAR);
+    }
+}
+
+/// Padded rows must be invisible: the world wider than a page still follows the reference.
+void test_buffer_padded_world() {
+    using namespace engine;
+
+    const Index width = 4096;
+    const Index height = 3;
+    WorldConfig config{256, 2, 1, 2};
+    config.huge_pages = true;
+    World world{width, height, LifeRule::conway(), GridTopology::TORUS, GridNeighborhood::MOORE, config};
+    ReferenceGrid reference{width, height, GridTopology::TORUS, GridNeighborhood::MOORE};
+    assert(world.stride() == row_stride(width));
+    seed_world(world, reference, 5);
+
+    run_and_compare(world, reference, 3);
+    for (Index i = 0; i != height; ++ i) {
+        auto row = world.row_cells(i);
+        assert(row.size() == width);
+        assert(reinterpret_cast<std::uintptr_t>(row.data()) % CACHE_LINE == 0);
+        for (Index j = 0; j != width; ++ j)
+            assert((row[j] == TransitionTable::FIRING) == (reference.get(i, j) == CellState::ALIVE));
+    }
+}
+
+void test_buffer() {
+    test_buffer_layout();
+    test_buffer_padded_world();
+}
+
+#endif //CPP_GAME_OF_DEATH_TEST_BUFFER_HPP
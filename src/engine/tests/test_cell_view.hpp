@@ -0,0 +1,102 @@
+#ifndef CPP_GAME_OF_DEATH_TEST_CELL_VIEW_HPP
+#define CPP_GAME_OF_DEATH_TEST_CELL_VIEW_HPP
+
+#include <cassert>
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+#include "engine/cell_view.hpp"
+#include "engine/ensemble.hpp"
+#include "engine/out_of_core.hpp"
+#include "engine/world.hpp"
+#include "engine/world3d.hpp"
+
+/// The view aliases the world's buffer and exports into caller memory with any row pitch.
+void test_cell_view_world() {
+    using namespace engine;
+
+    const Index width = 45, height = 13;
+    World world{width, height, GenerationsRule::brians_brain(), GridTopology::TORUS, GridNeighborhood::MOORE};
+    world.randomize(BoundingBox{0, 0, height, width}, 0.4, 5);
+    world.run(2);
+
+    auto view = world.view();
+    assert(view.rank() == 2 && view.extent(0) == height && view.extent(1) == width && view.stride(0) == world.stride());
+    assert(view.data_handle() == world.row_cells(0).data());
+    for (Index i = 0; i != height; ++ i)
+        for (Index j = 0; j != width; ++ j)
+            assert((view[i, j] == world.state(i, j)));
+    world.set_state(3, 4, 2);
+    assert((view[3, 4] == 2));
+
+    // Rows of 64 bytes, as a renderer uploading aligned rows would want them; the padding is left alone.
+    alignas(64) static std::uint8_t rows[height * 64];
+    std::fill(std::begin(rows), std::end(rows), 0xff);
+    export_cells(view, rows, 64);
+    for (Index i = 0; i != height; ++ i) {
+        for (Index j = 0; j != width; ++ j)
+            assert(rows[j + i * 64] == world.state(i, j));
+        assert(rows[width + i * 64] == 0xff);
+    }
+
+    std::vector<std::uint8_t> dense(width * height - 1);
+    bool thrown = false;
+    try {
+        export_cells(view, dense);
+    } catch (engine::errors::VIEW_EXPORT_TOO_SMALL &) {
+        thrown = true;
+    }
+    assert(thrown);
+}
+
+/// Strided views of the interleaved and the 3D engines, and packed rows of the out-of-core one.
+void test_cell_view_engines() {
+    using namespace engine;
+
+    Ensemble ensemble{9, 7, 70, LifeRule::conway(), GridTopology::TORUS, GridNeighborhood::MOORE};
+    ensemble.randomize(0.5, 3);
+    ensemble.step();
+    for (Index world: {0, 66}) {
+        auto view = ensemble.view(world);
+        std::vector<std::uint8_t> cells(9 * 7);
+        export_cells(view, cells);
+        for (Index i = 0; i != 7; ++ i)
+            for (Index j = 0; j != 9; ++ j) {
+                assert(((view[i, j] != 0) == (ensemble.get(world, i, j) == CellState::ALIVE)));
+                assert((cells[j + i * 9] == view[i, j]));
+            }
+    }
+
+    World3D cube{6, 5, 4, LifeRule::bays_4555(), GridTopology::TORUS, LatticeNeighborhood::VERTICES};
+    cube.randomize(0.3, 8);
+    auto volume = cube.view();
+    std::vector<std::uint8_t> cells(6 * 5 * 4);
+    export_cells(volume, cells);
+    for (Index k = 0; k != 4; ++ k)
+        for (Index i = 0; i != 5; ++ i)
+            for (Index j = 0; j != 6; ++ j) {
+                assert((volume[k, i, j] == (cube.get(i, j, k) == CellState::ALIVE)));
+                assert((cells[j + i * 6 + k * 30] == volume[k, i, j]));
+            }
+
+    auto directory = std::filesystem::temp_directory_path() / "cpp_game_of_death_test";
+    std::filesystem::create_directories(directory);
+    OutOfCoreWorld disk{directory, 100, 6, LifeRule::conway(), GridTopology::TORUS, GridNeighborhood::MOORE};
+    disk.randomize(0.5, 4);
+    std::vector<std::uint64_t> words(2 * 4);
+    auto packed = disk.export_rows(2, 4, words);
+    assert(packed.height == 4 && packed.row(0).size() == 2 && packed.row(3).data() == words.data() + 6);
+    for (Index i = 0; i != 4; ++ i) {
+        auto cells = disk.row_cells(i + 2);
+        for (Index j = 0; j != 100; ++ j)
+            assert(packed.alive(i, j) == (cells[j] != 0));
+    }
+}
+
+void test_cell_view() {
+    test_cell_view_world();
+    test_cell_view_engines();
+}
+
+#endif //CPP_GAME_OF_DEATH_TEST_CELL_VIEW_HPP
@@ -0,0 +1,59 @@
+#ifndef CPP_GAME_OF_DEATH_TEST_DIFFERENTIAL_HPP
+#define CPP_GAME_OF_DEATH_TEST_DIFFERENTIAL_HPP
+
+#include <cassert>
+#include <memory>
+#include <numeric>
+
+#include "differential.hpp"
+
+/// World stepping HighLife instead of Conway's Life: it only differs on births with 6 neighbors.
+class HighLifeEngine : public differential::Engine {
+    std::unique_ptr<engine::World> world_;
+
+public:
+    std::string name() const override { return "highlife"; }
+
+    void load(const differential::Scenario &scenario) override {
+        world_ = std::make_unique<engine::World>(
+            scenario.width, scenario.height, engine::LifeRule::parse("B36/S23"), scenario.topology,
+            scenario.neighborhood
+        );
+        for (engine::Index i = 0; i != scenario.height; ++ i)
+            for (engine::Index j = 0; j != scenario.width; ++ j)
+                if (scenario.alive(i, j))
+                    world_->set(i, j, conway::CellState::ALIVE);
+    }
+
+    void step() override { world_->step(); }
+
+    bool alive(engine::Index i, engine::Index j) const override {
+        return world_->get(i, j) == conway::CellState::ALIVE;
+    }
+};
+
+/// The harness must accept a correct engine, catch a wrong one and shrink the repro.
+void test_differential() {
+    using namespace differential;
+
+    auto scenario = soup(16, 16, GridTopology::TORUS, GridNeighborhood::MOORE, 0.45, 5);
+    auto trajectory = trace(scenario, 8);
+    assert(trajectory.generations.size() == 9);
+
+    WorldEngine world{"world", engine::WorldConfig{4, 4, 2, 2}};
+    assert(!compare(world, scenario, trajectory).divergence);
+
+    HighLifeEngine highlife;
+    auto outcome = compare(highlife, scenario, trajectory);
+    assert(outcome.divergence);
+    auto divergence = *outcome.divergence;
+    minimize(highlife, divergence);
+    auto population = [](const Scenario &s) { return std::accumulate(s.cells.begin(), s.cells.end(), Index{0}); };
+    assert(population(divergence.minimized) < population(scenario));
+    // Six alive neighbors are the smallest repro of a B6 birth.
+    assert(divergence.generation == 1 && population(divergence.minimized) == 6 && !divergence.expected);
+    auto again = compare(highlife, divergence.minimized, trace(divergence.minimized, divergence.generation));
+    assert(again.divergence && again.divergence->i == divergence.i && again.divergence->j == divergence.j);
+}
+
+#endif //CPP_GAME_OF_DEATH_TEST_DIFFERENTIAL_HPP
@@ -0,0 +1,89 @@
+#ifndef CPP_GAME_OF_DEATH_TEST_EDITS_HPP
+#define CPP_GAME_OF_DEATH_TEST_EDITS_HPP
+
+#include <cassert>
+#include <thread>
+#include <vector>
+
+#include "engine/edit_queue.hpp"
+#include "engine/pipeline.hpp"
+#include "engine/world.hpp"
+
+void test_edits_order() {
+    using namespace engine;
+
+    WorldConfig config{4, 4};
+    config.pyramid_block = 2;
+    World world{8, 8, LifeRule::parse("B/S012345678"), GridTopology::RAW, GridNeighborhood::MOORE, config};
+
+    auto first = world.submit(PastePattern{2, 2, 3, {1, 1, 1, 0, 1, 0}});
+    auto second = world.submit(ClearRegion{BoundingBox{2, 3, 4, 4}});
+    auto third = world.submit(SetCell{3, 3, 1});
+    assert(!world.is_applied(first));
+    assert(world.stats().population == 0);
+
+    assert(world.apply_edits() == 3);
+    assert(world.is_applied(first) && world.is_applied(second) && world.is_applied(third));
+    world.wait_applied(third);
+    assert(world.get(2, 2) == CellState::ALIVE);
+    assert(world.get(2, 3) == CellState::DEAD);
+    assert(world.get(2, 4) == CellState::ALIVE);
+    assert(world.get(3, 3) == CellState::ALIVE);
+    assert(world.stats().population == 3);
+    assert((world.stats().bounds == BoundingBox{2, 2, 4, 5}));
+    assert(world.tile_stats(0).population == 2);
+    assert(world.tile_stats(1).population == 1);
+    assert(world.pyramid().population(world.pyramid().levels() - 1, 0, 0) == 3);
+
+    // Edits wait for the next generation.
+    world.submit(ClearRegion{BoundingBox{0, 0, 8, 8}});
+    assert(world.stats().population == 3);
+    world.step();
+    assert(world.stats().population == 0);
+    assert(world.stats().bounds.empty());
+    assert(world.apply_edits() == 0);
+
+    bool thrown = false;
+    try { world.submit(SetCell{8, 0, 1}); } catch (engine::errors::WORLD_OUT_OF_RANGE &) { thrown = true; }
+    assert(thrown);
+    thrown = false;
+    try { world.submit(SetCell{0, 0, 2}); } catch (engine::errors::TRANSITION_OUT_OF_RANGE &) { thrown = true; }
+    assert(thrown);
+    thrown = false;
+    try { world.submit(PastePattern{7, 0, 2, {1, 1, 1, 1}}); } catch (engine::errors::WORLD_OUT_OF_RANGE &) { thrown = true; }
+    assert(thrown);
+}
+
+/// Several threads edit a world a Pipeline keeps stepping; every edit must land and be acknowledged.
+void test_edits_concurrent() {
+    using namespace engine;
+
+    const Index producers = 4;
+    const Index side = 16;
+    World world{side, side, LifeRule::parse("B/S012345678"), GridTopology::TORUS, GridNeighborhood::MOORE};
+    {
+        Pipeline pipeline{world, {2, 1, 0}};
+        std::vector<std::jthread> threads;
+        for (Index producer = 0; producer != producers; ++ producer)
+            threads.emplace_back([&world, producer] {
+                EditTicket last = 0;
+                for (Index i = producer; i < side; i += producers)
+                    for (Index j = 0; j != side; ++ j)
+                        last = world.submit(SetCell{i, j, 1});
+                world.wait_applied(last);
+            });
+        while (true) {
+            auto frame = pipeline.next();
+            if ((*frame)->stats().population == side * side)
+                break;
+        }
+    }
+    assert(world.stats().population == side * side);
+}
+
+void test_edits() {
+    test_edits_order();
+    test_edits_concurrent();
+}
+
+#endif //CPP_GAME_OF_DEATH_TEST_EDITS_HPP
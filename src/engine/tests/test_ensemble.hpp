@@ -0,0 +1,88 @@
+#ifndef CPP_GAME_OF_DEATH_TEST_ENSEMBLE_HPP
+#define CPP_GAME_OF_DEATH_TEST_ENSEMBLE_HPP
+
+#include <cassert>
+#include <vector>
+
+#include "engine/ensemble.hpp"
+#include "reference_grid.hpp"
+
+/// Every world of the ensemble must evolve exactly like its own reference node grid.
+void test_ensemble_matches_reference(
+    engine::Index width,
+    engine::Index height,
+    engine::Index worlds,
+    engine::GridTopology topology,
+    engine::GridNeighborhood neighborhood
+) {
+    using namespace engine;
+
+    Ensemble ensemble{width, height, worlds, LifeRule::conway(), topology, neighborhood};
+    std::vector<ReferenceGrid> references;
+    for (Index world = 0; world != worlds; ++ world) {
+        references.emplace_back(width, height, topology, neighborhood);
+        for (Index i = 0; i != height; ++ i)
+            for (Index j = 0; j != width; ++ j) {
+                auto state = soup_cell(world, j + i * width) ? CellState::ALIVE : CellState::DEAD;
+                ensemble.set(world, i, j, state);
+                references[world].set(i, j, state);
+            }
+    }
+
+    for (int generation = 0; generation != 6; ++ generation) {
+        ensemble.step();
+        for (Index world = 0; world != worlds; ++ world) {
+            auto &reference = references[world];
+            Index population = 0;
+            reference.step();
+            for (Index i = 0; i != height; ++ i)
+                for (Index j = 0; j != width; ++ j) {
+                    assert(ensemble.get(world, i, j) == reference.get(i, j));
+                    population += reference.get(i, j) == CellState::ALIVE;
+                }
+            // Terminated worlds are fixed points, so their frozen population is still exact.
+            assert(ensemble.stats(world).population == population);
+        }
+    }
+}
+
+void test_ensemble_termination() {
+    using namespace engine;
+
+    Ensemble ensemble{4, 4, 3, LifeRule::conway(), GridTopology::RAW, GridNeighborhood::MOORE};
+    // World 0 stays dead, world 1 holds a block (still life), world 2 a blinker (period 2).
+    for (Index i: {1, 2})
+        for (Index j: {1, 2})
+            ensemble.set(1, i, j, CellState::ALIVE);
+    for (Index j: {0, 1, 2})
+        ensemble.set(2, 1, j, CellState::ALIVE);
+    assert(ensemble.stats(1).population == 4);
+
+    auto performed = ensemble.run(10);
+    assert(performed == 10);
+    assert(ensemble.stats(0).status == WorldStatus::EXTINCT);
+    assert(ensemble.stats(0).generation == 1);
+    assert(ensemble.stats(1).status == WorldStatus::STABLE);
+    assert(ensemble.stats(1).population == 4);
+    assert(ensemble.stats(2).status == WorldStatus::RUNNING);
+    assert(ensemble.stats(2).births == 2 && ensemble.stats(2).deaths == 2);
+    assert(ensemble.stats(2).generation == 10);
+
+    // Killing the blinker lets the whole ensemble terminate.
+    for (Index i = 0; i != 4; ++ i)
+        for (Index j = 0; j != 4; ++ j)
+            ensemble.set(2, i, j, CellState::DEAD);
+    assert(ensemble.run(10) == 1);
+    assert(ensemble.all_terminated());
+}
+
+void test_ensemble() {
+    using namespace engine;
+
+    for (auto topology: {GridTopology::RAW, GridTopology::TORUS, GridTopology::REFLECT})
+        for (auto neighborhood: {GridNeighborhood::VON_NEUMANN, GridNeighborhood::MOORE})
+            test_ensemble_matches_reference(5, 4, 70, topology, neighborhood);
+    test_ensemble_termination();
+}
+
+#endif //CPP_GAME_OF_DEATH_TEST_ENSEMBLE_HPP
@@ -0,0 +1,93 @@
+#ifndef CPP_GAME_OF_DEATH_TEST_GENERATIONS_HPP
+#define CPP_GAME_OF_DEATH_TEST_GENERATIONS_HPP
+
+#include <cassert>
+
+#include "engine/generations.hpp"
+#include "engine/world.hpp"
+#include "topology/grid.hpp"
+#include "reference_grid.hpp"
+
+struct StarWarsNodeExecutor : public engine::GenerationsNodeExecutor {
+    StarWarsNodeExecutor() : GenerationsNodeExecutor(engine::GenerationsRule::star_wars()) {};
+};
+
+void test_generations_rule() {
+    using namespace engine;
+
+    assert(GenerationsRule::parse("B2/S/C3") == GenerationsRule::brians_brain());
+    assert(GenerationsRule::parse("B2/S345/C4") == GenerationsRule::star_wars());
+    assert(GenerationsRule::parse("B3/S23").states == 2);
+    assert(TransitionTable{GenerationsRule::parse("B3/S23")} == TransitionTable{LifeRule::conway()});
+
+    bool thrown = false;
+    try { GenerationsRule::parse("B2/S/C1"); } catch (engine::errors::RULE_SYNTAX &) { thrown = true; }
+    assert(thrown);
+
+    // Brian's Brain: firing -> refractory -> dead, dead with exactly two firing neighbors fires.
+    TransitionTable brain{GenerationsRule::brians_brain()};
+    assert(brain.states() == 3);
+    assert(brain.next(1, 2) == 2);
+    assert(brain.next(2, 2) == 0);
+    assert(brain.next(0, 2) == 1);
+    assert(brain.next(0, 3) == 0);
+
+    // A general N-state totalistic rule: cyclic counter advancing when any neighbor fires.
+    TransitionTable cyclic{5, [](std::uint8_t state, unsigned firing) -> std::uint8_t {
+        return firing ? (state + 1) % 5 : state;
+    }};
+    assert(cyclic.next(4, 1) == 0);
+    assert(cyclic.next(3, 0) == 3);
+
+    thrown = false;
+    try { TransitionTable{2, [](std::uint8_t, unsigned) -> std::uint8_t { return 2; }}; }
+    catch (engine::errors::TRANSITION_OUT_OF_RANGE &) { thrown = true; }
+    assert(thrown);
+}
+
+/// Multi-state World must follow a node grid of GenerationsNodeExecutor.
+void test_generations_world(engine::GridTopology topology, engine::WorldConfig config) {
+    using namespace engine;
+    using namespace topology::grid;
+
+    const Index width = 11;
+    const Index height = 7;
+    auto rule = GenerationsRule::star_wars();
+    World world{width, height, rule, topology, GridNeighborhood::MOORE, config};
+    auto grid = make_grid<GenerationsNode, StarWarsNodeExecutor>(
+        width, height, nullptr, topology, GridNeighborhood::MOORE
+    );
+
+    for (Index i = 0; i != height; ++ i)
+        for (Index j = 0; j != width; ++ j) {
+            auto state = static_cast<std::uint8_t>(soup_cell(7, j + i * width) ? 1 : (i + j) % rule.states);
+            world.set_state(i, j, state);
+            grid[assets::ij_2_idx(i, j, width)]->value()->stage(state);
+            grid[assets::ij_2_idx(i, j, width)]->value()->commit();
+        }
+
+    for (int generation = 0; generation != 8; ++ generation) {
+        world.step();
+        step(grid);
+        Index firing = 0;
+        for (Index i = 0; i != height; ++ i)
+            for (Index j = 0; j != width; ++ j) {
+                auto state = grid[assets::ij_2_idx(i, j, width)]->value()->get();
+                assert(world.state(i, j) == state);
+                firing += state == TransitionTable::FIRING;
+            }
+        assert(world.stats().population == firing);
+    }
+}
+
+void test_generations() {
+    using namespace engine;
+
+    test_generations_rule();
+    for (auto topology: {GridTopology::RAW, GridTopology::TORUS, GridTopology::REFLECT}) {
+        test_generations_world(topology, {4, 3, 1});
+        test_generations_world(topology, {64, 64, 2});
+    }
+}
+
+#endif //CPP_GAME_OF_DEATH_TEST_GENERATIONS_HPP
@@ -0,0 +1,76 @@
+#ifndef CPP_GAME_OF_DEATH_TEST_LIGHT_CONE_HPP
+#define CPP_GAME_OF_DEATH_TEST_LIGHT_CONE_HPP
+
+#include <cassert>
+
+#include "engine/light_cone.hpp"
+#include "engine/world.hpp"
+
+/// Queries must give the same cells as stepping a copy of the whole world.
+void test_light_cone_matches_world(
+    engine::TransitionTable transitions,
+    engine::GridTopology topology,
+    engine::GridNeighborhood neighborhood,
+    engine::Index tile
+) {
+    using namespace engine;
+
+    const Index width = 37, height = 29;
+    World world{width, height, transitions, topology, neighborhood};
+    World stepped{width, height, transitions, topology, neighborhood};
+    world.randomize(BoundingBox{0, 0, height, width}, 0.35, 77);
+    stepped.randomize(BoundingBox{0, 0, height, width}, 0.35, 77);
+
+    LightCone cone{world, tile};
+    const BoundingBox regions[] = {{0, 0, 1, 1}, {13, 20, 15, 26}, {height - 3, width - 5, height, width}};
+    for (Index generation = 0; generation <= 2 * tile + 3; ++ generation) {
+        for (auto &region: regions) {
+            auto states = cone.query(region, generation);
+            Index n = 0;
+            for (Index i = region.top; i != region.bottom; ++ i)
+                for (Index j = region.left; j != region.right; ++ j)
+                    assert(states[n ++] == stepped.state(i, j));
+        }
+        stepped.step();
+    }
+    assert(cone.state(5, 6, 0) == world.state(5, 6));
+}
+
+/// Overlapping queries reuse memoized tiles; stepping the world invalidates the cone until reset().
+void test_light_cone_memo() {
+    using namespace engine;
+
+    World world{256, 256, LifeRule::conway(), GridTopology::TORUS, GridNeighborhood::MOORE};
+    world.randomize(BoundingBox{0, 0, 256, 256}, 0.4, 3);
+    LightCone cone{world, 8};
+
+    cone.query(BoundingBox{100, 100, 101, 101}, 24);
+    Index first = cone.computed_tiles();
+    // Tiles 1, 2 and 3 levels below the target: 3 x 3, 5 x 5 and the target one itself.
+    assert(first == 1 + 9 + 25);
+    cone.query(BoundingBox{100, 100, 101, 101}, 24);
+    assert(cone.computed_tiles() == first);
+    cone.query(BoundingBox{100, 108, 101, 109}, 24);
+    assert(cone.computed_tiles() == first + 1 + 3 + 5);
+
+    world.step();
+    bool thrown = false;
+    try { cone.query(BoundingBox{0, 0, 1, 1}, 1); } catch (engine::errors::LIGHT_CONE_STALE &) { thrown = true; }
+    assert(thrown);
+    cone.reset();
+    assert(cone.cached_tiles() == 0 && cone.state(0, 0, 0) == world.state(0, 0));
+}
+
+void test_light_cone() {
+    using namespace engine;
+
+    for (auto topology: {GridTopology::RAW, GridTopology::TORUS, GridTopology::REFLECT})
+        for (auto neighborhood: {GridNeighborhood::VON_NEUMANN, GridNeighborhood::MOORE}) {
+            test_light_cone_matches_world(LifeRule::conway(), topology, neighborhood, 4);
+            test_light_cone_matches_world(GenerationsRule::brians_brain(), topology, neighborhood, 7);
+        }
+    test_light_cone_matches_world(LifeRule::conway(), GridTopology::TORUS, GridNeighborhood::MOORE, 64);
+    test_light_cone_memo();
+}
+
+#endif //CPP_GAME_OF_DEATH_TEST_LIGHT_CONE_HPP
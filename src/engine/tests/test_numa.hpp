@@ -0,0 +1,52 @@
+#ifndef CPP_GAME_OF_DEATH_TEST_NUMA_HPP
+#define CPP_GAME_OF_DEATH_TEST_NUMA_HPP
+
+#include <cassert>
+#include <numeric>
+
+#include "engine/numa.hpp"
+#include "engine/world.hpp"
+#include "reference_grid.hpp"
+#include "test_world.hpp"
+
+void test_numa_layout() {
+    using namespace engine::numa;
+
+    assert((engine::numa::assets::parse_cpu_list("0-3,8,10-11\n") == std::vector<int>{0, 1, 2, 3, 8, 10, 11}));
+    assert(engine::numa::assets::parse_cpu_list("").empty());
+
+    MachineLayout layout{{{0, 1, 2}, {4, 5, 6}}};
+    assert((assign_cpus(4, AffinityPolicy::COMPACT, layout) == std::vector<int>{0, 1, 2, 4}));
+    assert((assign_cpus(4, AffinityPolicy::SCATTER, layout) == std::vector<int>{0, 4, 1, 5}));
+    assert((assign_cpus(8, AffinityPolicy::SCATTER, layout) == std::vector<int>{0, 4, 1, 5, 2, 6, 0, 4}));
+    assert(assign_cpus(4, AffinityPolicy::NONE, layout).empty());
+
+    auto local = machine_layout();
+    assert(local.nodes() >= 1);
+}
+
+/// Pinned workers and first-touch placement must not change the results.
+void test_numa_world() {
+    using namespace engine;
+
+    const Index width = 40;
+    const Index height = 30;
+    WorldConfig config{8, 8, 3};
+    config.affinity = numa::AffinityPolicy::SCATTER;
+    World world{width, height, LifeRule::conway(), GridTopology::TORUS, GridNeighborhood::MOORE, config};
+    ReferenceGrid reference{width, height, GridTopology::TORUS, GridNeighborhood::MOORE};
+    seed_world(world, reference, 11);
+    run_and_compare(world, reference, 3);
+
+    // Both buffers are touched, so if the platform reports placement at all it covers them.
+    auto placement = world.memory_placement();
+    if (!placement.empty())
+        assert(std::accumulate(placement.begin(), placement.end(), Index{0}) >= 2);
+}
+
+void test_numa() {
+    test_numa_layout();
+    test_numa_world();
+}
+
+#endif //CPP_GAME_OF_DEATH_TEST_NUMA_HPP
@@ -0,0 +1,132 @@
+#ifndef CPP_GAME_OF_DEATH_TEST_OUT_OF_CORE_HPP
+#define CPP_GAME_OF_DEATH_TEST_OUT_OF_CORE_HPP
+
+#include <cassert>
+#include <filesystem>
+#include <iterator>
+#include <string>
+
+#include "engine/out_of_core.hpp"
+#include "engine/world.hpp"
+
+/// Streaming @param band rows at a time must step like World, whatever the band and word boundaries.
+void test_out_of_core_matches_world(
+    engine::LifeRule rule,
+    engine::GridTopology topology,
+    engine::GridNeighborhood neighborhood,
+    engine::Index width,
+    engine::Index height,
+    engine::Index band
+) {
+    using namespace engine;
+
+    auto directory = std::filesystem::temp_directory_path() / "cpp_game_of_death_test";
+    std::filesystem::create_directories(directory);
+    // The window holds 4 bands and 10 more rows, see OutOfCoreWorld::window_bytes().
+    Index row_bytes = (width + 63) / 64 * 8;
+    OutOfCoreWorld disk{directory, width, height, rule, topology, neighborhood, (4 * band + 10) * row_bytes};
+    assert(disk.band_rows() == std::min(band, height) && disk.window_bytes() == (4 * disk.band_rows() + 10) * row_bytes);
+    World world{width, height, rule, topology, neighborhood};
+    disk.randomize(0.4, 99);
+    world.randomize(BoundingBox{0, 0, height, width}, 0.4, 99);
+
+    for (Index generation = 0; generation != 6; ++ generation) {
+        assert(disk.population() == world.stats().population && disk.generation() == generation);
+        for (Index i = 0; i != height; ++ i) {
+            auto cells = disk.row_cells(i);
+            for (Index j = 0; j != width; ++ j)
+                assert(cells[j] == world.state(i, j));
+        }
+        disk.step();
+        world.step();
+    }
+}
+
+/// Single cells are read and written in place, keeping the population.
+void test_out_of_core_cells() {
+    using namespace engine;
+
+    auto directory = std::filesystem::temp_directory_path() / "cpp_game_of_death_test";
+    std::filesystem::create_directories(directory);
+    auto files = [&directory] {
+        auto entries = std::filesystem::directory_iterator{directory};
+        return std::distance(std::filesystem::begin(entries), std::filesystem::end(entries));
+    };
+    const auto before = files();
+    {
+        OutOfCoreWorld disk{directory, 100, 5, LifeRule::conway(), GridTopology::TORUS, GridNeighborhood::MOORE, 1};
+        assert(disk.band_rows() == 1 && disk.population() == 0);
+        // A blinker across the word boundary, with its middle on the last column of the first word.
+        disk.set(2, 62, CellState::ALIVE);
+        disk.set(2, 63, CellState::ALIVE);
+        disk.set(2, 64, CellState::ALIVE);
+        disk.set(2, 64, CellState::ALIVE);
+        assert(disk.population() == 3 && disk.get(2, 63) == CellState::ALIVE && disk.get(1, 63) == CellState::DEAD);
+        disk.step();
+        assert(disk.population() == 3 && disk.get(1, 63) == CellState::ALIVE && disk.get(2, 62) == CellState::DEAD);
+        disk.set(1, 63, CellState::DEAD);
+        assert(disk.population() == 2);
+
+        bool thrown = false;
+        try {
+            disk.get(5, 0);
+        } catch (engine::errors::OUT_OF_CORE_OUT_OF_RANGE &) {
+            thrown = true;
+        }
+        assert(thrown);
+
+        // A second world in the same directory gets its own files.
+        {
+            OutOfCoreWorld other{directory, 100, 5};
+            assert(files() == before + 4);
+            other.set(0, 0, CellState::ALIVE);
+            assert(disk.get(0, 0) == CellState::DEAD && disk.population() == 2);
+        }
+        assert(files() == before + 2 && disk.population() == 2 && disk.get(2, 63) == CellState::ALIVE);
+    }
+    assert(files() == before);
+
+    bool thrown = false;
+    try {
+        OutOfCoreWorld{directory, 8, 8, LifeRule::parse("B5/S"), GridTopology::RAW, GridNeighborhood::VON_NEUMANN};
+    } catch (engine::errors::OUT_OF_CORE_BAD_CONFIG &) {
+        thrown = true;
+    }
+    assert(thrown);
+}
+
+/// A generation file cut short under the world is reported as such, not with a stale errno.
+void test_out_of_core_truncated() {
+    using namespace engine;
+
+    auto directory = std::filesystem::temp_directory_path() / "cpp_game_of_death_test" / "truncated";
+    std::filesystem::create_directories(directory);
+    OutOfCoreWorld disk{directory, 8, 8};
+    for (auto &entry: std::filesystem::directory_iterator{directory})
+        std::filesystem::resize_file(entry.path(), 0);
+    std::string message;
+    try {
+        disk.get(7, 7);
+    } catch (engine::errors::OUT_OF_CORE_IO &error) {
+        message = error.what();
+    }
+    assert(message.ends_with("pread: unexpected end of file"));
+}
+
+void test_out_of_core() {
+    using namespace engine;
+
+    for (auto topology: {GridTopology::RAW, GridTopology::TORUS, GridTopology::REFLECT})
+        for (auto neighborhood: {GridNeighborhood::VON_NEUMANN, GridNeighborhood::MOORE})
+            for (Index width: {1, 64, 70, 130}) {
+                auto other = LifeRule::parse(neighborhood == GridNeighborhood::MOORE ? "B36/S23" : "B24/S13");
+                test_out_of_core_matches_world(LifeRule::conway(), topology, neighborhood, width, 7, 2);
+                test_out_of_core_matches_world(other, topology, neighborhood, width, 5, 3);
+            }
+    test_out_of_core_matches_world(LifeRule::conway(), GridTopology::TORUS, GridNeighborhood::MOORE, 67, 9, 1);
+    test_out_of_core_matches_world(LifeRule::parse("B2/S"), GridTopology::REFLECT, GridNeighborhood::MOORE, 67, 9, 9);
+    test_out_of_core_cells();
+    test_out_of_core_truncated();
+}
+
+#endif //CPP_GAME_OF_DEATH_TEST_OUT_OF_CORE_HPP
@@ -0,0 +1,63 @@
+#ifndef CPP_GAME_OF_DEATH_TEST_PIPELINE_HPP
+#define CPP_GAME_OF_DEATH_TEST_PIPELINE_HPP
+
+#include <cassert>
+#include <chrono>
+#include <thread>
+
+#include "engine/pipeline.hpp"
+#include "reference_grid.hpp"
+#include "test_world.hpp"
+
+/// Frames must arrive in order and match the reference, although the world runs ahead of the consumer.
+void test_pipeline_frames() {
+    using namespace engine;
+
+    const Index width = 9;
+    const Index height = 7;
+    World world{width, height, LifeRule::conway(), GridTopology::TORUS, GridNeighborhood::MOORE, {4, 4, 2}};
+    ReferenceGrid reference{width, height, GridTopology::TORUS, GridNeighborhood::MOORE};
+    seed_world(world, reference, 3);
+
+    Index consumed = 0;
+    {
+        Pipeline pipeline{world, {3, 2, 6}};
+        while (auto frame = pipeline.next()) {
+            assert((*frame)->generation() == 2 * consumed);
+            for (Index i = 0; i != height; ++ i)
+                for (Index j = 0; j != width; ++ j)
+                    assert(((*frame)->state(i, j) == 1) == (reference.get(i, j) == CellState::ALIVE));
+            reference.step();
+            reference.step();
+            ++ consumed;
+        }
+    }
+    assert(consumed == 6);
+    assert(world.generation() == 10);
+}
+
+/// The producer must not run further ahead than the frame pool allows.
+void test_pipeline_back_pressure() {
+    using namespace engine;
+
+    World world{16, 16};
+    std::optional<FrameHandle> survivor;
+    Pipeline pipeline{world, {2, 1, 0}};
+    auto first = pipeline.next();
+    auto second = pipeline.next();
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    assert(pipeline.produced() == 2);
+    assert((*first)->generation() == 0 && (*second)->generation() == 1);
+
+    first.reset();
+    survivor = pipeline.next();
+    assert((*survivor)->generation() == 2);
+    // The survivor handle outlives the pipeline, which stops as soon as it's destroyed.
+}
+
+void test_pipeline() {
+    test_pipeline_frames();
+    test_pipeline_back_pressure();
+}
+
+#endif //CPP_GAME_OF_DEATH_TEST_PIPELINE_HPP
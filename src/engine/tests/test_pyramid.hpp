@@ -0,0 +1,95 @@
+#ifndef CPP_GAME_OF_DEATH_TEST_PYRAMID_HPP
+#define CPP_GAME_OF_DEATH_TEST_PYRAMID_HPP
+
+#include <cassert>
+
+#include "engine/pyramid.hpp"
+#include "engine/world.hpp"
+#include "reference_grid.hpp"
+
+/// Every level of the world's pyramid must hold the alive cells of its blocks.
+void check_pyramid(const engine::World &world) {
+    using namespace engine;
+
+    auto &pyramid = world.pyramid();
+    for (Index level = 0; level != pyramid.levels(); ++ level) {
+        auto view = world.viewport(BoundingBox{0, 0, world.height(), world.width()}, level);
+        assert(view.rows() == pyramid.level_rows(level) && view.cols() == pyramid.level_cols(level));
+        for (Index r = 0; r != view.rows(); ++ r)
+            for (Index c = 0; c != view.cols(); ++ c) {
+                auto rect = view.rect(r, c);
+                Index expected = 0;
+                for (Index i = rect.top; i != rect.bottom; ++ i)
+                    for (Index j = rect.left; j != rect.right; ++ j)
+                        expected += world.get(i, j) == CellState::ALIVE;
+                assert(view.population(r, c) == expected);
+                assert(view.any_alive(r, c) == (expected != 0));
+            }
+    }
+    assert(pyramid.level_rows(pyramid.levels() - 1) == 1 && pyramid.level_cols(pyramid.levels() - 1) == 1);
+    assert(pyramid.population(pyramid.levels() - 1, 0, 0) == world.stats().population);
+}
+
+void test_pyramid_follows_world(engine::Index temporal_depth) {
+    using namespace engine;
+
+    WorldConfig config{8, 4, 2, temporal_depth};
+    config.pyramid_block = 2;
+    World world{37, 21, LifeRule::conway(), GridTopology::TORUS, GridNeighborhood::MOORE, config};
+    for (Index i = 0; i != world.height(); ++ i)
+        for (Index j = 0; j != world.width(); ++ j)
+            if (soup_cell(3, j + i * world.width()))
+                world.set(i, j, CellState::ALIVE);
+    check_pyramid(world);
+
+    for (int round = 0; round != 4; ++ round) {
+        world.run(2 * temporal_depth);
+        check_pyramid(world);
+        world.set(round, round, CellState::DEAD);
+        world.set(20 - round, 36, CellState::ALIVE);
+        check_pyramid(world);
+    }
+}
+
+void test_pyramid_viewport() {
+    using namespace engine;
+
+    PopulationPyramid pyramid{10, 6, 2};
+    assert(pyramid.levels() == 4);
+    pyramid.adjust(5, 9, 1);
+    pyramid.adjust(0, 0, 1);
+
+    auto view = pyramid.viewport(BoundingBox{3, 7, 6, 10}, 0);
+    assert(view.rows() == 2 && view.cols() == 2);
+    assert((view.blocks() == BoundingBox{1, 3, 3, 5}));
+    assert(view.population(1, 1) == 1 && view.population(0, 0) == 0);
+    assert((view.rect(1, 1) == BoundingBox{4, 8, 6, 10}));
+    assert(view.density(1, 1) == 0.25);
+
+    auto coarse = pyramid.viewport(BoundingBox{0, 0, 6, 10}, 1);
+    assert(coarse.block() == 4 && coarse.rows() == 2 && coarse.cols() == 3);
+    assert(coarse.population(0, 0) == 1 && coarse.population(1, 2) == 1);
+    assert(coarse.density(1, 2) == 0.25);
+
+    assert(pyramid.viewport(BoundingBox{}, 2).rows() == 0);
+    assert(pyramid.viewport(BoundingBox{6, 0, 9, 4}, 0).rows() == 0);
+
+    bool thrown = false;
+    try { pyramid.viewport(BoundingBox{0, 0, 1, 1}, 4); } catch (engine::errors::PYRAMID_OUT_OF_RANGE &) { thrown = true; }
+    assert(thrown);
+
+    thrown = false;
+    WorldConfig config{8, 8};
+    config.pyramid_block = 3;
+    try { World{16, 16, LifeRule::conway(), GridTopology::RAW, GridNeighborhood::MOORE, config}; }
+    catch (engine::errors::WORLD_BAD_CONFIG &) { thrown = true; }
+    assert(thrown);
+}
+
+void test_pyramid() {
+    test_pyramid_viewport();
+    test_pyramid_follows_world(1);
+    test_pyramid_follows_world(3);
+}
+
+#endif //CPP_GAME_OF_DEATH_TEST_PYRAMID_HPP
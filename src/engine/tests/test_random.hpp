@@ -0,0 +1,135 @@
+#ifndef CPP_GAME_OF_DEATH_TEST_RANDOM_HPP
+#define CPP_GAME_OF_DEATH_TEST_RANDOM_HPP
+
+#include <cassert>
+
+#include "engine/ensemble.hpp"
+#include "engine/random.hpp"
+#include "engine/thread_pool.hpp"
+#include "engine/world.hpp"
+#include "engine/world3d.hpp"
+#include "test_pyramid.hpp"
+
+void test_random_density() {
+    using namespace engine::random;
+
+    static_assert(cell_bits(1, 2) == cell_bits(1, 2) && cell_bits(1, 2) != cell_bits(2, 1));
+    static_assert(!cell_alive(7, 0, Density{0}) && cell_alive(7, 0, Density{1}));
+    bool thrown = false;
+    try { Density{1.5}; } catch (engine::errors::RANDOM_BAD_DENSITY &) { thrown = true; }
+    assert(thrown);
+
+    engine::Index alive = 0;
+    const engine::Index cells = 100000;
+    for (engine::Index index = 0; index != cells; ++ index)
+        alive += cell_alive(42, index, Density{0.3});
+    assert(alive > cells * 29 / 100 && alive < cells * 31 / 100);
+}
+
+/// The soup depends on the seed and the cell only, not on the tiling or the number of threads.
+void test_random_world() {
+    using namespace engine;
+
+    const Index width = 45, height = 37;
+    WorldConfig config{8, 4, 3};
+    config.pyramid_block = 4;
+    World single{width, height, LifeRule::conway(), GridTopology::TORUS, GridNeighborhood::MOORE};
+    World tiled{width, height, LifeRule::conway(), GridTopology::TORUS, GridNeighborhood::MOORE, config};
+    single.randomize(BoundingBox{0, 0, height, width}, 0.4, 2024);
+    tiled.randomize(BoundingBox{0, 0, height, width}, 0.4, 2024);
+    Index population = 0;
+    BoundingBox bounds;
+    for (Index i = 0; i != height; ++ i)
+        for (Index j = 0; j != width; ++ j) {
+            assert(single.state(i, j) == tiled.state(i, j));
+            if (single.get(i, j) == CellState::ALIVE) {
+                ++ population;
+                bounds.include(BoundingBox{i, j, i + 1, j + 1});
+            }
+        }
+    assert(population > 0 && single.stats().population == population && tiled.stats().population == population);
+    assert(tiled.stats().bounds == bounds);
+    check_pyramid(tiled);
+
+    // Outside of the area cells are kept; inside, the same seed gives the same cells.
+    BoundingBox area{5, 7, 20, 30};
+    tiled.randomize(area, 0, 1);
+    tiled.randomize(area, 1, 1);
+    for (Index i = 0; i != height; ++ i)
+        for (Index j = 0; j != width; ++ j) {
+            bool inside = i >= area.top && i < area.bottom && j >= area.left && j < area.right;
+            assert(inside ? tiled.get(i, j) == CellState::ALIVE : tiled.state(i, j) == single.state(i, j));
+        }
+    check_pyramid(tiled);
+    tiled.run(3);
+    check_pyramid(tiled);
+
+    bool thrown = false;
+    try {
+        single.randomize(BoundingBox{0, 0, height + 1, width}, 0.5, 0);
+    } catch (engine::errors::WORLD_OUT_OF_RANGE &) {
+        thrown = true;
+    }
+    assert(thrown);
+}
+
+void test_random_ensemble() {
+    using namespace engine;
+
+    const Index width = 9, height = 7;
+    Ensemble ensemble{width, height, 70, LifeRule::conway(), GridTopology::TORUS, GridNeighborhood::MOORE};
+    ensemble.randomize(0.5, 100);
+    for (Index world: {Index{0}, Index{63}, Index{69}}) {
+        World single{width, height, LifeRule::conway(), GridTopology::TORUS, GridNeighborhood::MOORE};
+        single.randomize(BoundingBox{0, 0, height, width}, 0.5, random::mix(100, world));
+        for (Index i = 0; i != height; ++ i)
+            for (Index j = 0; j != width; ++ j)
+                assert(ensemble.get(world, i, j) == single.get(i, j));
+        assert(ensemble.stats(world).population == single.stats().population);
+    }
+
+    // Same soups whatever the threads; the batch of the next seed doesn't repeat the worlds of this one.
+    Ensemble pooled{width, height, 70, LifeRule::conway(), GridTopology::TORUS, GridNeighborhood::MOORE};
+    Ensemble next{width, height, 70, LifeRule::conway(), GridTopology::TORUS, GridNeighborhood::MOORE};
+    ThreadPool pool{3};
+    pooled.randomize(0.5, 100, pool);
+    next.randomize(0.5, 101);
+    bool shifted = true;
+    for (Index world = 0; world != 70; ++ world)
+        for (Index i = 0; i != height; ++ i)
+            for (Index j = 0; j != width; ++ j) {
+                assert(pooled.get(world, i, j) == ensemble.get(world, i, j));
+                if (world + 1 != 70 && next.get(world, i, j) != ensemble.get(world + 1, i, j))
+                    shifted = false;
+            }
+    assert(!shifted && pooled.stats(69).population == ensemble.stats(69).population);
+}
+
+void test_random_world3d() {
+    using namespace engine;
+
+    World3D single{11, 6, 9, LifeRule::bays_4555(), GridTopology::TORUS, LatticeNeighborhood::VERTICES, 1};
+    World3D parallel{11, 6, 9, LifeRule::bays_4555(), GridTopology::TORUS, LatticeNeighborhood::VERTICES, 4};
+    single.randomize(0.25, 9);
+    parallel.randomize(0.25, 9);
+    Index population = 0;
+    for (Index k = 0; k != 9; ++ k)
+        for (Index i = 0; i != 6; ++ i)
+            for (Index j = 0; j != 11; ++ j) {
+                assert(single.get(i, j, k) == parallel.get(i, j, k));
+                population += single.get(i, j, k) == CellState::ALIVE;
+            }
+    assert(population > 0 && single.population() == population && parallel.population() == population);
+    single.run(2);
+    parallel.run(2);
+    assert(single.population() == parallel.population());
+}
+
+void test_random() {
+    test_random_density();
+    test_random_world();
+    test_random_ensemble();
+    test_random_world3d();
+}
+
+#endif //CPP_GAME_OF_DEATH_TEST_RANDOM_HPP
@@ -0,0 +1,117 @@
+#ifndef CPP_GAME_OF_DEATH_TEST_STATIC_GRID_HPP
+#define CPP_GAME_OF_DEATH_TEST_STATIC_GRID_HPP
+
+#include <cassert>
+
+#include "engine/static_grid.hpp"
+#include "engine/world.hpp"
+
+namespace static_grid_fixtures {
+    using namespace engine;
+
+    using Torus8 = StaticGrid<8, 8>;
+
+    constexpr Torus8 GLIDER{{
+        ".O......",
+        "..O.....",
+        "OOO.....",
+        "........",
+        "........",
+        "........",
+        "........",
+        "........",
+    }};
+
+    constexpr bool blinker_oscillates() {
+        StaticGrid<5, 5, GridTopology::RAW> blinker{{".....", ".....", ".OOO.", ".....", "....."}};
+        auto start = blinker;
+        blinker.step();
+        bool vertical = blinker.get(1, 2) == CellState::ALIVE && blinker.get(2, 1) == CellState::DEAD;
+        blinker.step();
+        return vertical && blinker == start && blinker.generation() == 2;
+    }
+
+    /// A glider moves one cell diagonally every 4 generations, so it comes back after 32 on an 8 x 8 torus.
+    constexpr bool glider_wraps() {
+        auto glider = GLIDER;
+        glider.run(4);
+        bool moved = glider.get(3, 2) == CellState::ALIVE && glider.population() == 5 && !(glider == GLIDER);
+        glider.run(28);
+        return moved && glider == GLIDER;
+    }
+
+    /// On a RAW grid the glider ends up as a block in the corner.
+    constexpr bool glider_stops_at_raw_border() {
+        StaticGrid<8, 8, GridTopology::RAW> glider{{
+            ".O......", "..O.....", "OOO.....", "........", "........", "........", "........", "........"
+        }};
+        glider.run(40);
+        return glider.population() == 4 && glider.get(7, 7) == CellState::ALIVE && glider.get(6, 6) == CellState::ALIVE;
+    }
+
+    static_assert(blinker_oscillates());
+    static_assert(glider_wraps());
+    static_assert(glider_stops_at_raw_border());
+    static_assert(sizeof(StaticGrid<16, 16>) == 16 * 8 + sizeof(Index));
+}
+
+/// Random soups must evolve as in World, for every topology and neighborhood.
+template<engine::Index Width, engine::Index Height, engine::GridTopology Topology, engine::GridNeighborhood Neighborhood>
+void test_static_grid_matches_world(engine::Index generations) {
+    using namespace engine;
+
+    constexpr LifeRule rule = Neighborhood == GridNeighborhood::MOORE ? LifeRule{1u << 3 | 1u << 6, 1u << 2 | 1u << 3}
+                                                                       : LifeRule{1u << 1 | 1u << 3, 1u << 2};
+    StaticGrid<Width, Height, Topology, rule, Neighborhood> grid;
+    World world{Width, Height, rule, Topology, Neighborhood};
+    grid.randomize(0.4, 31);
+    world.randomize(BoundingBox{0, 0, Height, Width}, 0.4, 31);
+    for (Index generation = 0; generation <= generations; ++ generation) {
+        assert(grid.population() == world.stats().population);
+        auto view = grid.view();
+        for (Index i = 0; i != Height; ++ i)
+            for (Index j = 0; j != Width; ++ j) {
+                assert(grid.get(i, j) == world.get(i, j));
+                assert(view.alive(i, j) == (world.get(i, j) == CellState::ALIVE));
+            }
+        grid.step();
+        world.step();
+    }
+}
+
+template<engine::GridTopology Topology, engine::GridNeighborhood Neighborhood>
+void test_static_grid_shapes() {
+    test_static_grid_matches_world<8, 8, Topology, Neighborhood>(12);
+    test_static_grid_matches_world<1, 3, Topology, Neighborhood>(4);
+    test_static_grid_matches_world<37, 5, Topology, Neighborhood>(12);
+    test_static_grid_matches_world<64, 16, Topology, Neighborhood>(12);
+}
+
+void test_static_grid() {
+    using namespace engine;
+
+    test_static_grid_shapes<GridTopology::RAW, GridNeighborhood::VON_NEUMANN>();
+    test_static_grid_shapes<GridTopology::RAW, GridNeighborhood::MOORE>();
+    test_static_grid_shapes<GridTopology::TORUS, GridNeighborhood::VON_NEUMANN>();
+    test_static_grid_shapes<GridTopology::TORUS, GridNeighborhood::MOORE>();
+    test_static_grid_shapes<GridTopology::REFLECT, GridNeighborhood::VON_NEUMANN>();
+    test_static_grid_shapes<GridTopology::REFLECT, GridNeighborhood::MOORE>();
+
+    StaticGrid<16, 16> grid;
+    bool thrown = false;
+    try {
+        grid.set(16, 0, CellState::ALIVE);
+    } catch (engine::errors::STATIC_GRID_OUT_OF_RANGE &) {
+        thrown = true;
+    }
+    assert(thrown);
+    thrown = false;
+    try {
+        StaticGrid<3, 1> bad{{"O#."}};
+    } catch (engine::errors::STATIC_GRID_BAD_PATTERN &) {
+        thrown = true;
+    }
+    assert(thrown);
+}
+
+#endif //CPP_GAME_OF_DEATH_TEST_STATIC_GRID_HPP
@@ -0,0 +1,160 @@
+#ifndef CPP_GAME_OF_DEATH_TEST_WORLD_HPP
+#define CPP_GAME_OF_DEATH_TEST_WORLD_HPP
+
+#include <cassert>
+
+#include "engine/world.hpp"
+#include "reference_grid.hpp"
+
+/// Seeds both the world and the reference with the same soup.
+inline void seed_world(engine::World &world, ReferenceGrid &reference, std::uint64_t seed) {
+    using namespace engine;
+    for (Index i = 0; i != world.height(); ++ i)
+        for (Index j = 0; j != world.width(); ++ j) {
+            auto state = soup_cell(seed, j + i * world.width()) ? CellState::ALIVE : CellState::DEAD;
+            world.set(i, j, state);
+            reference.set(i, j, state);
+        }
+}
+
+/// Runs @param generations of both the world and the reference, then checks that every cell matches.
+inline void run_and_compare(engine::World &world, ReferenceGrid &reference, engine::Index generations) {
+    using namespace engine;
+    world.run(generations);
+    for (Index generation = 0; generation != generations; ++ generation)
+        reference.step();
+    for (Index i = 0; i != world.height(); ++ i)
+        for (Index j = 0; j != world.width(); ++ j)
+            assert(world.get(i, j) == reference.get(i, j));
+}
+
+/// Cells, world counters and tile counters must follow the reference node grid.
+void test_world_matches_reference(
+    engine::Index width,
+    engine::Index height,
+    engine::GridTopology topology,
+    engine::GridNeighborhood neighborhood,
+    engine::WorldConfig config
+) {
+    using namespace engine;
+
+    World world{width, height, LifeRule::conway(), topology, neighborhood, config};
+    ReferenceGrid reference{width, height, topology, neighborhood};
+    seed_world(world, reference, width * 31 + height);
+
+    Index callbacks = 0;
+    world.on_generation([&callbacks](const World &w) {
+        ++ callbacks;
+        assert(w.stats().generation == callbacks);
+    });
+
+    for (int generation = 0; generation != 5; ++ generation) {
+        std::vector<CellState> before;
+        for (Index i = 0; i != height; ++ i)
+            for (Index j = 0; j != width; ++ j)
+                before.push_back(reference.get(i, j));
+
+        world.step();
+        reference.step();
+
+        GenerationStats expected;
+        std::vector<Index> tile_population(world.tile_count(), 0);
+        for (Index i = 0; i != height; ++ i)
+            for (Index j = 0; j != width; ++ j) {
+                auto was_alive = before[j + i * width] == CellState::ALIVE;
+                auto is_alive = reference.get(i, j) == CellState::ALIVE;
+                assert(world.get(i, j) == reference.get(i, j));
+                expected.population += is_alive;
+                expected.births += is_alive && !was_alive;
+                expected.deaths += was_alive && !is_alive;
+                if (is_alive) {
+                    expected.bounds.include(BoundingBox{i, j, i + 1, j + 1});
+                    ++ tile_population[(j / config.tile_width) + (i / config.tile_height) * world.tile_cols()];
+                }
+            }
+
+        auto &stats = world.stats();
+        assert(stats.population == expected.population);
+        assert(stats.births == expected.births);
+        assert(stats.deaths == expected.deaths);
+        assert(stats.changed == expected.births + expected.deaths);
+        assert(stats.bounds == expected.bounds);
+        for (Index tile = 0; tile != world.tile_count(); ++ tile)
+            assert(world.tile_stats(tile).population == tile_population[tile]);
+    }
+    assert(callbacks == 5);
+}
+
+void test_world_edits() {
+    using namespace engine;
+
+    World world{8, 8, LifeRule::conway(), GridTopology::RAW, GridNeighborhood::MOORE, {4, 4, 1}};
+    world.set(1, 1, CellState::ALIVE);
+    world.set(6, 5, CellState::ALIVE);
+    assert(world.stats().population == 2);
+    assert((world.stats().bounds == BoundingBox{1, 1, 7, 6}));
+    assert(world.tile_stats(0).population == 1);
+    assert(world.tile_stats(3).population == 1);
+
+    world.set(6, 5, CellState::DEAD);
+    assert(world.stats().population == 1);
+    assert((world.stats().bounds == BoundingBox{1, 1, 2, 2}));
+
+    world.step();
+    assert(world.stats().population == 0);
+    assert(world.stats().deaths == 1);
+    assert(world.stats().bounds.empty());
+}
+
+/// Temporally blocked run() must end in the same state as stepping the reference one generation at a time.
+void test_world_temporal_blocking(
+    engine::Index width,
+    engine::Index height,
+    engine::GridTopology topology,
+    engine::GridNeighborhood neighborhood,
+    engine::WorldConfig config
+) {
+    using namespace engine;
+
+    World world{width, height, LifeRule::conway(), topology, neighborhood, config};
+    World stepped{width, height, LifeRule::conway(), topology, neighborhood};
+    ReferenceGrid reference{width, height, topology, neighborhood};
+    seed_world(world, reference, width + height * 17);
+    for (Index i = 0; i != height; ++ i)
+        for (Index j = 0; j != width; ++ j)
+            stepped.set(i, j, world.get(i, j));
+
+    Index callbacks = 0;
+    world.on_generation([&callbacks](const World &) { ++ callbacks; });
+
+    const Index generations = 2 * config.temporal_depth + 1;
+    run_and_compare(world, reference, generations);
+    stepped.run(generations);
+    assert(callbacks == 3);
+    assert(world.generation() == generations);
+    assert(world.stats().population == stepped.stats().population);
+    assert(world.stats().births == stepped.stats().births);
+    assert(world.stats().deaths == stepped.stats().deaths);
+    assert(world.stats().bounds == stepped.stats().bounds);
+}
+
+void test_world() {
+    using namespace engine;
+
+    for (auto topology: {GridTopology::RAW, GridTopology::TORUS, GridTopology::REFLECT})
+        for (auto neighborhood: {GridNeighborhood::VON_NEUMANN, GridNeighborhood::MOORE}) {
+            test_world_matches_reference(13, 9, topology, neighborhood, {5, 4, 1});
+            test_world_matches_reference(13, 9, topology, neighborhood, {64, 64, 3});
+            test_world_matches_reference(1, 5, topology, neighborhood, {2, 2, 2});
+        }
+    test_world_edits();
+
+    for (auto topology: {GridTopology::RAW, GridTopology::TORUS, GridTopology::REFLECT})
+        for (auto neighborhood: {GridNeighborhood::VON_NEUMANN, GridNeighborhood::MOORE}) {
+            test_world_temporal_blocking(17, 12, topology, neighborhood, {8, 5, 2, 3});
+            test_world_temporal_blocking(17, 12, topology, neighborhood, {4, 3, 1, 5});
+            test_world_temporal_blocking(5, 4, topology, neighborhood, {64, 64, 1, 6});
+        }
+}
+
+#endif //CPP_GAME_OF_DEATH_TEST_WORLD_HPP
@@ -0,0 +1,112 @@
+#ifndef CPP_GAME_OF_DEATH_TEST_WORLD3D_HPP
+#define CPP_GAME_OF_DEATH_TEST_WORLD3D_HPP
+
+#include <cassert>
+
+#include "engine/world3d.hpp"
+#include "topology/lattice.hpp"
+#include "reference_grid.hpp"
+
+/// Node reference of World3D: applies a LifeRule to the alive neighbors it is subscribed to.
+class LifeRuleNodeExecutor : public topology::BatchNodeExecutor<LifeRuleNodeExecutor, conway::CellState> {
+    engine::LifeRule rule_;
+
+public:
+    explicit LifeRuleNodeExecutor(engine::LifeRule rule) : rule_{rule} {};
+
+    void exec() override {
+        unsigned alive = 0;
+        for (auto *neighbor: *node()->neighborhood())
+            alive += neighbor->value()->get() == conway::CellState::ALIVE;
+        bool is_alive = node()->value()->get() == conway::CellState::ALIVE;
+        node()->value()->stage(rule_.next(is_alive, alive) ? conway::CellState::ALIVE : conway::CellState::DEAD);
+    }
+};
+
+void test_lattice_neighbors() {
+    using namespace topology::lattice;
+    using conway::ConwayNode;
+
+    static_assert(neighbor_count(LatticeNeighborhood::EDGES) == 18);
+    auto raw = make_lattice<ConwayNode>(4, 3, 5, nullptr, GridTopology::RAW, LatticeNeighborhood::VERTICES);
+    assert(raw[0]->neighborhood()->size() == 7);
+    assert(raw[topology::lattice::assets::ijk_2_idx(1, 1, 1, 4, 3)]->neighborhood()->size() == 26);
+    auto edges = make_lattice<ConwayNode>(4, 3, 5, nullptr, GridTopology::RAW, LatticeNeighborhood::EDGES);
+    assert(edges[0]->neighborhood()->size() == 6);
+    auto faces = make_lattice<ConwayNode>(4, 3, 5, nullptr, GridTopology::TORUS, LatticeNeighborhood::FACES);
+    assert(faces[0]->neighborhood()->size() == 6);
+}
+
+/// Separable sums must give the same generations as the node lattice.
+void test_world3d_matches_lattice(
+    engine::Index width,
+    engine::Index height,
+    engine::Index depth,
+    engine::LifeRule rule,
+    engine::GridTopology topology,
+    engine::LatticeNeighborhood neighborhood,
+    engine::Index threads
+) {
+    using namespace engine;
+    using conway::ConwayNode;
+
+    static LifeRule lattice_rule;
+    lattice_rule = rule;
+    auto lattice = topology::lattice::make_lattice<ConwayNode>(
+        width, height, depth,
+        [](Index, Index, Index, Index, Index, Index) -> topology::NodeExecutor<CellState> * {
+            return new LifeRuleNodeExecutor(lattice_rule);
+        },
+        topology, neighborhood
+    );
+    World3D world{width, height, depth, rule, topology, neighborhood, threads};
+
+    Index idx = 0;
+    for (Index k = 0; k != depth; ++ k)
+        for (Index i = 0; i != height; ++ i)
+            for (Index j = 0; j != width; ++ j, ++ idx) {
+                auto state = soup_cell(width + depth, idx) ? CellState::ALIVE : CellState::DEAD;
+                world.set(i, j, k, state);
+                lattice[idx]->value()->stage(state);
+                lattice[idx]->value()->commit();
+            }
+
+    for (int generation = 0; generation != 4; ++ generation) {
+        world.step();
+        topology::grid::step(lattice);
+        Index population = 0;
+        idx = 0;
+        for (Index k = 0; k != depth; ++ k)
+            for (Index i = 0; i != height; ++ i)
+                for (Index j = 0; j != width; ++ j, ++ idx) {
+                    assert(world.get(i, j, k) == lattice[idx]->value()->get());
+                    population += world.get(i, j, k) == CellState::ALIVE;
+                }
+        assert(world.population() == population);
+    }
+}
+
+void test_world3d() {
+    using namespace engine;
+
+    test_lattice_neighbors();
+    assert(LifeRule::parse_counts("B5/S4,5") == LifeRule::bays_4555());
+    assert((LifeRule::parse_counts("B13-15,26/S") == LifeRule{(7u << 13) | (1u << 26), 0}));
+    assert((LifeRule::parse_counts("B/S2") == LifeRule{0, 1u << 2}));
+    for (auto notation: {"B5-3/S2", "B5,/S4", "B,5/S4", "B5,,6/S", "B5-/S", "B5/S4,"}) {
+        bool thrown = false;
+        try { LifeRule::parse_counts(notation); } catch (engine::errors::RULE_SYNTAX &) { thrown = true; }
+        assert(thrown);
+    }
+
+    const LifeRule rules[] = {LifeRule::bays_4555(), LifeRule::parse_counts("B4-6/S3-7"), LifeRule::parse_counts("B1,3/S2")};
+    for (auto topology: {GridTopology::RAW, GridTopology::TORUS, GridTopology::REFLECT})
+        for (auto neighborhood: {LatticeNeighborhood::FACES, LatticeNeighborhood::EDGES, LatticeNeighborhood::VERTICES})
+            for (auto &rule: rules) {
+                test_world3d_matches_lattice(6, 5, 4, rule, topology, neighborhood, 1);
+                test_world3d_matches_lattice(5, 4, 7, rule, topology, neighborhood, 3);
+                test_world3d_matches_lattice(1, 2, 3, rule, topology, neighborhood, 2);
+            }
+}
+
+#endif //CPP_GAME_OF_DEATH_TEST_WORLD3D_HPP
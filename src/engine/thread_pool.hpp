@@ -0,0 +1,124 @@
+#ifndef CPP_GAME_OF_DEATH_THREAD_POOL_HPP
+#define CPP_GAME_OF_DEATH_THREAD_POOL_HPP
+
+#include <algorithm>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "numa.hpp"
+
+namespace engine {
+    using topology::Index;
+
+    /**
+     * Persistent workers running data-parallel loops.
+     * Tasks are split statically: worker w always receives the same contiguous range of tasks for the same task count,
+     * so the data a worker touched during one run() stays in its caches (and memory node) for the next one.
+     * The calling thread acts as worker 0, unless the workers are pinned to CPUs: then all of them are pool threads.
+     */
+    class ThreadPool {
+        using Job = std::function<void(Index task, Index worker)>;
+
+        std::vector<std::jthread> workers_;
+        /// Index of the first pool thread's worker: 1 when the calling thread participates, 0 otherwise.
+        Index first_pooled_{1};
+        std::mutex mutex_;
+        std::condition_variable wake_;
+        std::condition_variable done_;
+        const Job *job_ = nullptr;
+        Index tasks_{};
+        Index round_{};
+        Index pending_{};
+
+        void run_range(const Job &job, Index worker) const {
+            for (Index task = first_task(tasks_, worker); task != first_task(tasks_, worker + 1); ++ task)
+                job(task, worker);
+        }
+
+        void work(std::stop_token stop, Index worker, int cpu) {
+            if (cpu >= 0)
+                numa::pin_current_thread(cpu);
+            Index seen_round = 0;
+            while (true) {
+                const Job *job;
+                {
+                    std::unique_lock lock{mutex_};
+                    wake_.wait(lock, [&] { return stop.stop_requested() || round_ != seen_round; });
+                    if (stop.stop_requested())
+                        return;
+                    seen_round = round_;
+                    job = job_;
+                }
+                run_range(*job, worker);
+                {
+                    std::lock_guard lock{mutex_};
+                    if (-- pending_ == 0)
+                        done_.notify_one();
+                }
+            }
+        }
+
+    public:
+        /**
+         * @param threads total number of workers including the calling thread (0 is treated as 1)
+         * @param cpus if not empty, worker w is a pool thread pinned to `cpus[w % cpus.size()]`
+         */
+        explicit ThreadPool(Index threads = 1, const std::vector<int> &cpus = {}) {
+            first_pooled_ = cpus.empty() ? 1 : 0;
+            for (Index worker = first_pooled_; worker < std::max<Index>(threads, 1); ++ worker) {
+                int cpu = cpus.empty() ? -1 : cpus[worker % cpus.size()];
+                workers_.emplace_back([this, worker, cpu](std::stop_token stop) { work(stop, worker, cpu); });
+            }
+        }
+
+        ~ThreadPool() {
+            for (auto &worker: workers_)
+                worker.request_stop();
+            {
+                std::lock_guard lock{mutex_};
+                ++ round_;
+            }
+            wake_.notify_all();
+            workers_.clear();
+        }
+
+        ThreadPool(const ThreadPool &) = delete;
+        ThreadPool &operator = (const ThreadPool &) = delete;
+
+        /// Number of workers including the calling thread.
+        Index size() const {
+            return workers_.size() + first_pooled_;
+        }
+
+        /// First task of @param worker's range when @param tasks are split among size() workers.
+        Index first_task(Index tasks, Index worker) const {
+            return tasks * worker / size();
+        }
+
+        /**
+         * Calls @param job (task, worker) for every task in [0, @param tasks) and waits for completion.
+         * Not reentrant: must not be called from inside a job.
+         */
+        void run(Index tasks, const Job &job) {
+            {
+                std::lock_guard lock{mutex_};
+                job_ = &job;
+                tasks_ = tasks;
+                pending_ = workers_.size();
+                ++ round_;
+            }
+            wake_.notify_all();
+            if (first_pooled_ != 0)
+                run_range(job, 0);
+
+            std::unique_lock lock{mutex_};
+            done_.wait(lock, [&] { return pending_ == 0; });
+            job_ = nullptr;
+        }
+    };
+}
+
+#endif //CPP_GAME_OF_DEATH_THREAD_POOL_HPP
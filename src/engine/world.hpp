@@ -0,0 +1,805 @@
+#ifndef CPP_GAME_OF_DEATH_WORLD_HPP
+#define CPP_GAME_OF_DEATH_WORLD_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <variant>
+#include <vector>
+
+#include "logger/metrics.hpp"
+#include "topology/conway_node.hpp"
+#include "bounding_box.hpp"
+#include "buffer.hpp"
+#include "cell_view.hpp"
+#include "edit_queue.hpp"
+#include "kernel.hpp"
+#include "numa.hpp"
+#include "pyramid.hpp"
+#include "random.hpp"
+#include "rule.hpp"
+#include "stencil.hpp"
+#include "thread_pool.hpp"
+
+namespace engine::errors {
+    struct WORLD_OUT_OF_RANGE : public std::out_of_range {
+        WORLD_OUT_OF_RANGE() : std::out_of_range("World cell or tile index is out of range") {};
+    };
+
+    struct WORLD_BAD_CONFIG : public std::invalid_argument {
+        WORLD_BAD_CONFIG() : std::invalid_argument(
+            "World size and tile size must be positive, the pyramid block must divide the tile size"
+        ) {};
+    };
+}
+
+namespace engine {
+    using conway::CellState;
+
+    /// Tunables of the World stepping engine. They don't affect the results.
+    struct WorldConfig {
+        Index tile_width{64}; ///< Columns per tile.
+        Index tile_height{64}; ///< Rows per tile.
+        Index threads{1}; ///< Workers stepping tiles in parallel, including the calling thread.
+        /// Generations World::run() advances a tile at once while it is cache-resident. 1 disables temporal blocking.
+        Index temporal_depth{1};
+        /// Pinning of the workers. Anything but NONE makes all workers pool threads, see ThreadPool.
+        numa::AffinityPolicy affinity{numa::AffinityPolicy::NONE};
+        /// Back large cell buffers with huge pages, see CellBuffer. Whether it pays off depends on the machine.
+        bool huge_pages{false};
+        /// Side of the finest PopulationPyramid blocks, dividing the tile sizes. 0 doesn't maintain the pyramid.
+        Index pyramid_block{0};
+    };
+
+    /**
+     * Counters of a single tile, maintained by the worker stepping the tile.
+     * For multi-state rules "alive" means TransitionTable::FIRING.
+     */
+    struct alignas(64) TileStats {
+        Index population{}; ///< Alive cells.
+        Index births{}; ///< Cells became alive during the last generation.
+        Index deaths{}; ///< Cells stopped being alive during the last generation.
+        Index changed{}; ///< Cells whose state changed during the last generation.
+        BoundingBox bounds; ///< Smallest box containing all alive cells.
+    };
+
+    /// Whole-world counters, reduced from the tiles once per generation.
+    struct GenerationStats {
+        Index generation{};
+        Index population{};
+        Index births{};
+        Index deaths{};
+        Index changed{};
+        BoundingBox bounds;
+    };
+
+    /**
+     * Flat-buffer engine for a single large world.
+     *
+     * Cell states are stored row by row, one byte per cell, in two buffers whose rows are padded to a cache-aligned
+     * stride (see CellBuffer and row_stride()): the exec phase computes the next generation of every tile into the
+     * back buffer (tiles are spread over the ThreadPool), then the commit phase swaps the buffers.
+     * The world is surrounded by a one-cell ghost frame, filled before every generation according to the topology
+     * (see fill_ghosts()), so the kernel reads the neighbors of border cells like any other and has no boundary
+     * checks. With a LifeRule it has the same semantic as stepping a make_grid() of conway::ConwayNodeExecutor nodes;
+     * any TransitionTable (e.g. a GenerationsRule) runs multi-state automata.
+     *
+     * Population statistics are a by-product of the exec phase, so querying them costs nothing.
+     */
+    class World {
+    public:
+        using Callback = std::function<void(const World &)>;
+
+    private:
+        Index width_;
+        Index height_;
+        /// Distance between row starts in the cell buffers, see row_stride().
+        Index stride_;
+        GridTopology topology_;
+        GridNeighborhood neighborhood_;
+        TransitionTable transitions_;
+        WorldConfig config_;
+        Index tile_rows_;
+        Index tile_cols_;
+
+        CellBuffer current_;
+        CellBuffer next_;
+
+        /// Per-worker buffers of a tile with its halo for temporal blocking.
+        struct Scratch {
+            std::vector<std::uint8_t> front;
+            std::vector<std::uint8_t> back;
+            std::vector<Index> columns;
+        };
+
+        std::vector<TileStats> tiles_;
+        PopulationPyramid pyramid_;
+        /// Tiles whose pyramid blocks were recounted by the exec phase and wait for PopulationPyramid::refresh().
+        std::vector<std::uint8_t> pyramid_dirty_;
+        std::vector<Scratch> scratch_;
+        GenerationStats stats_;
+        std::unique_ptr<ThreadPool> pool_;
+        std::unique_ptr<EditQueue> edits_{std::make_unique<EditQueue>()};
+        /// Tiles whose alive cells were changed by the edits being applied.
+        std::vector<std::uint8_t> edited_;
+        Callback on_generation_;
+
+        /**
+         * Position of cell (@param i, @param j) in the cell buffers. Rows start cache-aligned after a leading line and
+         * a ghost row; the ghost cells left and right of a row are the bytes just around it, in the row padding.
+         */
+        Index offset_of(Index i, Index j) const {
+            return CACHE_LINE + j + (i + 1) * stride_;
+        }
+
+        /// Cell (@param i, 0) of @param buffer. Its ghost neighbors are at -1, width_, -stride_ and +stride_.
+        const std::uint8_t *row(const CellBuffer &buffer, Index i) const {
+            return buffer.data() + offset_of(i, 0);
+        }
+
+        std::uint8_t *row(CellBuffer &buffer, Index i) {
+            return buffer.data() + offset_of(i, 0);
+        }
+
+        Index tile_of(Index i, Index j) const {
+            return (j / config_.tile_width) + (i / config_.tile_height) * tile_cols_;
+        }
+
+        static bool is_alive(std::uint8_t state) {
+            return state == TransitionTable::FIRING;
+        }
+
+        /**
+         * Fills the ghost frame of the current generation: dead for RAW, the opposite border for TORUS and the border
+         * itself for REFLECT. Columns go first, then the rows above and below are copied whole, corners included.
+         * A RAW frame is zeroed once by the constructor, as neither the kernel nor the edits write it.
+         */
+        void fill_ghosts() {
+            if (topology_ == GridTopology::RAW)
+                return;
+            const bool torus = topology_ == GridTopology::TORUS;
+            for (Index i = 0; i != height_; ++ i) {
+                std::uint8_t *cells = row(current_, i);
+                cells[-1] = torus ? cells[width_ - 1] : cells[0];
+                cells[width_] = torus ? cells[0] : cells[width_ - 1];
+            }
+            const std::uint8_t *top = row(current_, torus ? height_ - 1 : 0) - 1;
+            const std::uint8_t *bottom = row(current_, torus ? 0 : height_ - 1) - 1;
+            std::copy(top, top + width_ + 2, row(current_, 0) - 1 - stride_);
+            std::copy(bottom, bottom + width_ + 2, row(current_, height_ - 1) - 1 + stride_);
+        }
+
+        template<bool Moore, bool Binary>
+        void exec_row(Index i, Index j0, Index j1) {
+            const std::uint8_t *mid = row(current_, i);
+            const std::uint8_t *up = mid - stride_;
+            const std::uint8_t *down = mid + stride_;
+            std::uint8_t *out = row(next_, i);
+            const std::uint8_t *table = transitions_.data();
+            constexpr Index stride = TransitionTable::STRIDE;
+
+            for (Index j = j0; j != j1; ++ j) {
+                unsigned count = firing<Binary>(up[j]) + firing<Binary>(down[j]) +
+                                 firing<Binary>(mid[j - 1]) + firing<Binary>(mid[j + 1]);
+                if constexpr (Moore)
+                    count += firing<Binary>(up[j - 1]) + firing<Binary>(up[j + 1]) +
+                             firing<Binary>(down[j - 1]) + firing<Binary>(down[j + 1]);
+                out[j] = table[mid[j] * stride + count];
+            }
+        }
+
+        void exec_row(Index i, Index j0, Index j1) {
+            bool moore = neighborhood_ == GridNeighborhood::MOORE;
+            if (transitions_.is_binary())
+                moore ? exec_row<true, true>(i, j0, j1) : exec_row<false, true>(i, j0, j1);
+            else
+                moore ? exec_row<true, false>(i, j0, j1) : exec_row<false, false>(i, j0, j1);
+        }
+
+        /**
+         * Accumulates counters of row @param i, columns [@param left, @param left + @param count) into @param stats.
+         * @param before the row's cells at the previous generation, starting from column @param left
+         * @param after the row's cells at the new generation, starting from column @param left
+         */
+        static void tally_row(
+                const std::uint8_t *before,
+                const std::uint8_t *after,
+                Index i,
+                Index left,
+                Index count,
+                TileStats &stats
+        ) {
+            Index population = 0;
+            for (Index j = 0; j != count; ++ j) {
+                bool was_alive = is_alive(before[j]);
+                bool is_alive_now = is_alive(after[j]);
+                population += is_alive_now;
+                stats.births += is_alive_now && !was_alive;
+                stats.deaths += was_alive && !is_alive_now;
+                stats.changed += after[j] != before[j];
+            }
+            if (population != 0) {
+                Index first = 0;
+                while (!is_alive(after[first]))
+                    ++ first;
+                Index last = count;
+                while (!is_alive(after[last - 1]))
+                    -- last;
+                stats.bounds.include(BoundingBox{i, left + first, i + 1, left + last});
+            }
+            stats.population += population;
+        }
+
+        void exec_tile(Index tile) {
+            metrics::ScopedTimer timer{metrics::Phase::EXEC};
+            metrics::count(metrics::Counter::TILES);
+            BoundingBox rect = tile_rect(tile);
+            TileStats stats;
+            for (Index i = rect.top; i != rect.bottom; ++ i) {
+                exec_row(i, rect.left, rect.right);
+                tally_row(
+                    row(current_, i) + rect.left,
+                    row(next_, i) + rect.left,
+                    i,
+                    rect.left,
+                    rect.right - rect.left,
+                    stats
+                );
+            }
+            if (stats.changed != 0)
+                recount_tile_blocks(tile, next_);
+            tiles_[tile] = stats;
+        }
+
+        void relax(const std::uint8_t *src, std::uint8_t *dst, Index stride, Index r0, Index r1, Index c0, Index c1) {
+            engine::relax(transitions_, neighborhood_, src, dst, stride, r0, r1, c0, c1);
+        }
+
+        /**
+         * World coordinate of the scratch position @param pos when the scratch starts @param halo cells before
+         * @param origin along an axis of @param size.
+         * @return std::nullopt outside a RAW world
+         */
+        std::optional<Index> axis_coordinate(Index origin, Index pos, Index halo, Index size) const {
+            auto shift = static_cast<int>(pos) - static_cast<int>(halo);
+            return neighbor_index(0, origin, {0, shift}, size, 1, topology_);
+        }
+
+        /**
+         * Advances @param tile by @param depth generations at once (temporal blocking).
+         * The tile is loaded with a halo of @param depth cells into the worker's scratch, which stays in cache while
+         * the computed area shrinks by one cell per generation (a trapezoid); only the last generation is written back.
+         * Halos of the neighbor tiles overlap, so their cells are recomputed redundantly instead of being exchanged.
+         */
+        void exec_tile_blocked(Index tile, Index depth, Scratch &scratch) {
+            metrics::ScopedTimer timer{metrics::Phase::EXEC};
+            metrics::count(metrics::Counter::TILES);
+            BoundingBox rect = tile_rect(tile);
+            const Index rows = rect.bottom - rect.top + 2 * depth;
+            const Index cols = rect.right - rect.left + 2 * depth;
+            const Index stride = row_stride(cols);
+            scratch.front.assign(rows * stride, 0);
+            scratch.back.assign(rows * stride, 0);
+
+            // Scratch cells outside a RAW world are never loaded nor computed, so they stay dead.
+            Index inside_top = rows, inside_bottom = 0;
+            for (Index r = 0; r != rows; ++ r)
+                if (axis_coordinate(rect.top, r, depth, height_)) {
+                    inside_top = std::min(inside_top, r);
+                    inside_bottom = r + 1;
+                }
+            scratch.columns.assign(cols, width_);
+            Index inside_left = cols, inside_right = 0;
+            for (Index c = 0; c != cols; ++ c)
+                if (auto j = axis_coordinate(rect.left, c, depth, width_)) {
+                    scratch.columns[c] = *j;
+                    inside_left = std::min(inside_left, c);
+                    inside_right = c + 1;
+                }
+
+            for (Index r = inside_top; r < inside_bottom; ++ r) {
+                Index i = *axis_coordinate(rect.top, r, depth, height_);
+                const std::uint8_t *src = row(current_, i);
+                std::uint8_t *dst = scratch.front.data() + r * stride;
+                for (Index c = inside_left; c < inside_right; ++ c)
+                    dst[c] = src[scratch.columns[c]];
+            }
+
+            for (Index s = 1; s <= depth; ++ s) {
+                relax(
+                    scratch.front.data(),
+                    scratch.back.data(),
+                    stride,
+                    std::max(s, inside_top),
+                    std::min(rows - s, inside_bottom),
+                    std::max(s, inside_left),
+                    std::min(cols - s, inside_right)
+                );
+                if (s != depth)
+                    scratch.front.swap(scratch.back);
+            }
+
+            TileStats stats;
+            const Index count = rect.right - rect.left;
+            bool moved = false;
+            for (Index i = rect.top; i != rect.bottom; ++ i) {
+                Index r = i - rect.top + depth;
+                const std::uint8_t *before = scratch.front.data() + r * stride + depth;
+                const std::uint8_t *after = scratch.back.data() + r * stride + depth;
+                // Statistics compare the last two generations, the pyramid needs a change since the first one.
+                if (pyramid_.levels() != 0 && !moved)
+                    moved = !std::equal(after, after + count, row(current_, i) + rect.left);
+                std::copy(after, after + count, row(next_, i) + rect.left);
+                tally_row(before, after, i, rect.left, count, stats);
+            }
+            if (moved)
+                recount_tile_blocks(tile, next_);
+            tiles_[tile] = stats;
+        }
+
+        /// Level 0 pyramid blocks of @param tile as a rectangle of blocks.
+        BoundingBox tile_blocks(Index tile) const {
+            BoundingBox rect = tile_rect(tile);
+            Index block = config_.pyramid_block;
+            return BoundingBox{
+                rect.top / block,
+                rect.left / block,
+                (rect.bottom + block - 1) / block,
+                (rect.right + block - 1) / block
+            };
+        }
+
+        /// Counts alive cells of the pyramid blocks of @param tile in @param cells and marks the tile for refresh.
+        void recount_tile_blocks(Index tile, const CellBuffer &cells) {
+            if (pyramid_.levels() == 0)
+                return;
+            BoundingBox blocks = tile_blocks(tile);
+            Index block = config_.pyramid_block;
+            for (Index r = blocks.top; r != blocks.bottom; ++ r)
+                for (Index c = blocks.left; c != blocks.right; ++ c) {
+                    Index population = 0;
+                    for (Index i = r * block; i != std::min((r + 1) * block, height_); ++ i) {
+                        const std::uint8_t *cell = row(cells, i);
+                        for (Index j = c * block; j != std::min((c + 1) * block, width_); ++ j)
+                            population += is_alive(cell[j]);
+                    }
+                    pyramid_.set_block(r, c, population);
+                }
+            pyramid_dirty_[tile] = 1;
+        }
+
+        /// Recomputes the bounds of @param tile from its cells.
+        void rescan_tile_bounds(Index tile) {
+            BoundingBox rect = tile_rect(tile);
+            BoundingBox bounds;
+            for (Index i = rect.top; i != rect.bottom; ++ i)
+                for (Index j = rect.left; j != rect.right; ++ j)
+                    if (is_alive(current_[offset_of(i, j)]))
+                        bounds.include(BoundingBox{i, j, i + 1, j + 1});
+            tiles_[tile].bounds = bounds;
+        }
+
+        /// Writes a cell for apply_edits(), keeping populations exact; bounds are rescanned afterwards.
+        void write_cell(Index i, Index j, std::uint8_t value) {
+            auto &cell = current_[offset_of(i, j)];
+            bool was_alive = is_alive(cell);
+            cell = value;
+            if (was_alive == is_alive(value))
+                return;
+            auto tile = tile_of(i, j);
+            tiles_[tile].population = was_alive ? tiles_[tile].population - 1 : tiles_[tile].population + 1;
+            stats_.population = was_alive ? stats_.population - 1 : stats_.population + 1;
+            if (pyramid_.levels() != 0)
+                pyramid_.adjust(i, j, was_alive ? -1 : 1);
+            edited_[tile] = 1;
+        }
+
+        void apply_edit(const SetCell &edit) {
+            write_cell(edit.i, edit.j, edit.state);
+        }
+
+        void apply_edit(const ClearRegion &edit) {
+            for (Index i = edit.area.top; i < edit.area.bottom; ++ i)
+                for (Index j = edit.area.left; j < edit.area.right; ++ j)
+                    write_cell(i, j, 0);
+        }
+
+        void apply_edit(const PastePattern &edit) {
+            for (Index r = 0; r != edit.rows(); ++ r)
+                for (Index c = 0; c != edit.cols; ++ c)
+                    write_cell(edit.top + r, edit.left + c, edit.states[c + r * edit.cols]);
+        }
+
+        /// @throw errors::WORLD_OUT_OF_RANGE or errors::TRANSITION_OUT_OF_RANGE if @param edit doesn't fit
+        void validate(const Edit &edit) const {
+            auto check_states = [this](auto first, auto last) {
+                if (std::any_of(first, last, [this](std::uint8_t state) { return state >= transitions_.states(); }))
+                    throw errors::TRANSITION_OUT_OF_RANGE();
+            };
+            if (auto *set = std::get_if<SetCell>(&edit)) {
+                if (set->i >= height_ || set->j >= width_)
+                    throw errors::WORLD_OUT_OF_RANGE();
+                check_states(&set->state, &set->state + 1);
+            } else if (auto *clear = std::get_if<ClearRegion>(&edit)) {
+                if (clear->area.bottom > height_ || clear->area.right > width_)
+                    throw errors::WORLD_OUT_OF_RANGE();
+            } else if (auto *paste = std::get_if<PastePattern>(&edit)) {
+                if (paste->cols == 0 || paste->states.size() % paste->cols != 0 ||
+                    paste->top + paste->rows() > height_ || paste->left + paste->cols > width_)
+                    throw errors::WORLD_OUT_OF_RANGE();
+                check_states(paste->states.begin(), paste->states.end());
+            }
+        }
+
+        void reduce_bounds() {
+            stats_.bounds = BoundingBox{};
+            for (auto &tile: tiles_)
+                stats_.bounds.include(tile.bounds);
+        }
+
+        /// Recomputes the pyramid levels above the tiles marked by recount_tile_blocks().
+        void refresh_pyramid() {
+            for (Index tile = 0; tile != pyramid_dirty_.size(); ++ tile)
+                if (pyramid_dirty_[tile]) {
+                    pyramid_.refresh(tile_blocks(tile));
+                    pyramid_dirty_[tile] = 0;
+                }
+        }
+
+        void commit(Index generations = 1) {
+            metrics::ScopedTimer timer{metrics::Phase::COMMIT};
+            current_.swap(next_);
+            refresh_pyramid();
+            auto generation = stats_.generation + generations;
+            stats_ = GenerationStats{};
+            stats_.generation = generation;
+            for (auto &tile: tiles_) {
+                stats_.population += tile.population;
+                stats_.births += tile.births;
+                stats_.deaths += tile.deaths;
+                stats_.changed += tile.changed;
+                stats_.bounds.include(tile.bounds);
+            }
+        }
+
+    public:
+        /**
+         * @param width world width
+         * @param height world height
+         * @param transitions rule of the automaton; a LifeRule or a GenerationsRule converts implicitly
+         * @param topology the way border cells are connected
+         * @param neighborhood same meaning as for make_grid()
+         * @param config tiling and threading
+         * @throw errors::WORLD_BAD_CONFIG on zero sizes
+         */
+        World(
+                Index width,
+                Index height,
+                TransitionTable transitions = LifeRule::conway(),
+                GridTopology topology = GridTopology::RAW,
+                GridNeighborhood neighborhood = GridNeighborhood::VON_NEUMANN,
+                WorldConfig config = {}
+        ) :
+            width_{width},
+            height_{height},
+            stride_{row_stride(width + 2)},
+            topology_{topology},
+            neighborhood_{neighborhood},
+            transitions_{std::move(transitions)},
+            config_{config}
+        {
+            if (width == 0 || height == 0 || config.tile_width == 0 || config.tile_height == 0)
+                throw errors::WORLD_BAD_CONFIG();
+            if (config.pyramid_block != 0 &&
+                (config.tile_width % config.pyramid_block != 0 || config.tile_height % config.pyramid_block != 0))
+                throw errors::WORLD_BAD_CONFIG();
+            metrics::ScopedTimer timer{metrics::Phase::GRID_BUILD};
+            tile_rows_ = (height_ + config_.tile_height - 1) / config_.tile_height;
+            tile_cols_ = (width_ + config_.tile_width - 1) / config_.tile_width;
+
+            tiles_.resize(tile_rows_ * tile_cols_);
+            edited_.assign(tiles_.size(), 0);
+            if (config_.pyramid_block != 0) {
+                pyramid_ = PopulationPyramid{width_, height_, config_.pyramid_block};
+                pyramid_dirty_.assign(tiles_.size(), 0);
+            }
+            pool_ = std::make_unique<ThreadPool>(
+                config_.threads,
+                numa::assign_cpus(config_.threads, config_.affinity, numa::machine_layout())
+            );
+            scratch_.resize(pool_->size());
+
+            // First touch: every tile's memory is zeroed by the worker which is going to step it,
+            // so its pages land on that worker's NUMA node. The ghost frame and the row padding follow.
+            current_ = CellBuffer{CACHE_LINE + stride_ * (height_ + 2), config_.huge_pages};
+            next_ = CellBuffer{CACHE_LINE + stride_ * (height_ + 2), config_.huge_pages};
+            pool_->run(tiles_.size(), [this](Index tile, Index) {
+                BoundingBox rect = tile_rect(tile);
+                for (Index i = rect.top; i != rect.bottom; ++ i) {
+                    std::fill(row(current_, i) + rect.left, row(current_, i) + rect.right, 0);
+                    std::fill(row(next_, i) + rect.left, row(next_, i) + rect.right, 0);
+                }
+            });
+            for (auto *buffer: {&current_, &next_}) {
+                std::fill(buffer->data(), row(*buffer, 0), 0);
+                for (Index i = 0; i != height_; ++ i)
+                    std::fill(row(*buffer, i) + width_, row(*buffer, i) + stride_, 0);
+                std::fill(row(*buffer, height_), buffer->data() + buffer->size(), 0);
+            }
+            config_.temporal_depth = std::max<Index>(config_.temporal_depth, 1);
+        }
+
+        Index width() const { return width_; }
+
+        Index height() const { return height_; }
+
+        GridTopology topology() const { return topology_; }
+
+        GridNeighborhood neighborhood() const { return neighborhood_; }
+
+        const TransitionTable &transitions() const { return transitions_; }
+
+        const WorldConfig &config() const { return config_; }
+
+        /// Number of generations performed.
+        Index generation() const { return stats_.generation; }
+
+        CellState get(Index i, Index j) const {
+            return is_alive(state(i, j)) ? CellState::ALIVE : CellState::DEAD;
+        }
+
+        /// Sets a cell of the current generation. Keeps population and bounds exact.
+        void set(Index i, Index j, CellState state) {
+            set_state(i, j, state == CellState::ALIVE ? TransitionTable::FIRING : 0);
+        }
+
+        /// Distance between row starts in the cell buffer, at least width() plus the ghost frame; see row_stride().
+        Index stride() const { return stride_; }
+
+        /// Raw states of row @param i of the current generation. Valid until the next step.
+        std::span<const std::uint8_t> row_cells(Index i) const {
+            if (i >= height_)
+                throw errors::WORLD_OUT_OF_RANGE();
+            return current_.span().subspan(offset_of(i, 0), width_);
+        }
+
+        /**
+         * Raw states of the current generation in place, indexed [i, j]: row stride is stride(), and the ghost frame is
+         * outside the view. Valid until the next step, which reuses the buffer; export_cells() copies it out.
+         */
+        CellView<2> view() const {
+            return make_cell_view<2>(current_.data() + offset_of(0, 0), {height_, width_}, {stride_, 1});
+        }
+
+        /// Page kind the cell buffers were allocated on.
+        PageKind pages() const { return current_.pages(); }
+
+        /**
+         * Resident pages of both cell buffers on each NUMA node (index is the node number).
+         * @return empty vector if the platform can't tell
+         */
+        std::vector<Index> memory_placement() const {
+            auto pages = numa::page_placement(current_.data(), current_.size());
+            auto next_pages = numa::page_placement(next_.data(), next_.size());
+            pages.resize(std::max(pages.size(), next_pages.size()), 0);
+            for (Index node = 0; node != next_pages.size(); ++ node)
+                pages[node] += next_pages[node];
+            return pages;
+        }
+
+        /// Raw state of a cell of the current generation.
+        std::uint8_t state(Index i, Index j) const {
+            if (i >= height_ || j >= width_)
+                throw errors::WORLD_OUT_OF_RANGE();
+            return current_[offset_of(i, j)];
+        }
+
+        /**
+         * Sets the raw state of a cell of the current generation. Keeps population and bounds exact.
+         * @throw errors::TRANSITION_OUT_OF_RANGE if @param value is not a state of the rule
+         */
+        void set_state(Index i, Index j, std::uint8_t value) {
+            if (i >= height_ || j >= width_)
+                throw errors::WORLD_OUT_OF_RANGE();
+            if (value >= transitions_.states())
+                throw errors::TRANSITION_OUT_OF_RANGE();
+            auto &cell = current_[offset_of(i, j)];
+            bool was_alive = is_alive(cell);
+            cell = value;
+            if (was_alive == is_alive(value))
+                return;
+
+            if (pyramid_.levels() != 0)
+                pyramid_.adjust(i, j, is_alive(value) ? 1 : -1);
+            auto &tile = tiles_[tile_of(i, j)];
+            if (is_alive(value)) {
+                ++ tile.population;
+                ++ stats_.population;
+                tile.bounds.include(BoundingBox{i, j, i + 1, j + 1});
+                stats_.bounds.include(tile.bounds);
+            } else {
+                -- tile.population;
+                -- stats_.population;
+                rescan_tile_bounds(tile_of(i, j));
+                reduce_bounds();
+            }
+        }
+
+        /**
+         * Fills @param area of the current generation with a random soup: a cell becomes alive (firing) with
+         * probability @param density, dead otherwise. Every cell is drawn from (@param seed, j + i * width()) alone,
+         * so the soup is the same whatever the tiling and the number of threads. Tiles are filled in parallel;
+         * population, bounds and pyramid are recomputed.
+         * @throw errors::WORLD_OUT_OF_RANGE if @param area reaches outside the world
+         * @throw errors::RANDOM_BAD_DENSITY if @param density is not within [0, 1]
+         */
+        void randomize(const BoundingBox &area, double density, std::uint64_t seed) {
+            if (area.bottom > height_ || area.right > width_)
+                throw errors::WORLD_OUT_OF_RANGE();
+            const random::Density probability{density};
+            metrics::ScopedTimer timer{metrics::Phase::GRID_BUILD};
+            pool_->run(tiles_.size(), [this, &area, &probability, seed](Index tile, Index) {
+                BoundingBox rect = tile_rect(tile);
+                BoundingBox fill{
+                    std::max(rect.top, area.top),
+                    std::max(rect.left, area.left),
+                    std::min(rect.bottom, area.bottom),
+                    std::min(rect.right, area.right)
+                };
+                if (fill.top >= fill.bottom || fill.left >= fill.right)
+                    return;
+                for (Index i = fill.top; i != fill.bottom; ++ i) {
+                    std::uint8_t *cells = row(current_, i);
+                    for (Index j = fill.left; j != fill.right; ++ j)
+                        cells[j] = random::cell_alive(seed, j + i * width_, probability) ? TransitionTable::FIRING : 0;
+                }
+                Index population = 0;
+                for (Index i = rect.top; i != rect.bottom; ++ i)
+                    for (Index j = rect.left; j != rect.right; ++ j)
+                        population += is_alive(current_[offset_of(i, j)]);
+                tiles_[tile].population = population;
+                rescan_tile_bounds(tile);
+                recount_tile_blocks(tile, current_);
+            });
+            refresh_pyramid();
+            stats_.population = 0;
+            for (auto &tile: tiles_)
+                stats_.population += tile.population;
+            reduce_bounds();
+        }
+
+        /**
+         * Queues @param edit to be applied at the start of the next generation, see apply_edits().
+         * Thread-safe and lock-free, may be called while another thread steps the world.
+         * @return ticket to check or wait for with is_applied() and wait_applied()
+         * @throw errors::WORLD_OUT_OF_RANGE if the edit reaches outside the world
+         * @throw errors::TRANSITION_OUT_OF_RANGE if a state is not a state of the rule
+         */
+        EditTicket submit(Edit edit) {
+            validate(edit);
+            return edits_->push(std::move(edit));
+        }
+
+        /// Whether the edit of @param ticket is applied. Thread-safe.
+        bool is_applied(EditTicket ticket) const { return edits_->is_applied(ticket); }
+
+        /// Blocks until the edit of @param ticket is applied. Thread-safe, but never call it from the stepping thread.
+        void wait_applied(EditTicket ticket) const { edits_->wait(ticket); }
+
+        /**
+         * Applies the submitted edits in submission order as one batch: population, tile and pyramid counters are
+         * updated per cell, bounds once per touched tile. Called by step() and step_blocked() before computing;
+         * must be called from the stepping thread only.
+         * @return number of edits applied
+         */
+        Index apply_edits() {
+            Index applied = edits_->drain([this](const Edit &edit) {
+                std::visit([this](const auto &variant) { apply_edit(variant); }, edit);
+            });
+            if (applied == 0)
+                return 0;
+            for (Index tile = 0; tile != tiles_.size(); ++ tile)
+                if (edited_[tile]) {
+                    rescan_tile_bounds(tile);
+                    edited_[tile] = 0;
+                }
+            reduce_bounds();
+            return applied;
+        }
+
+        /// Advances the world by one generation.
+        void step() {
+            apply_edits();
+            fill_ghosts();
+            pool_->run(tiles_.size(), [this](Index tile, Index) { exec_tile(tile); });
+            commit();
+            if (on_generation_)
+                on_generation_(*this);
+            metrics::publish(stats_.generation);
+        }
+
+        /**
+         * Advances @param depth generations at once with temporal blocking, see WorldConfig::temporal_depth.
+         * Statistics and the generation callback are produced once, for the last of the generations:
+         * births, deaths and changed cells compare it with the generation before it.
+         */
+        void step_blocked(Index depth) {
+            if (depth <= 1)
+                return step();
+            apply_edits();
+            pool_->run(tiles_.size(), [this, depth](Index tile, Index worker) {
+                exec_tile_blocked(tile, depth, scratch_[worker]);
+            });
+            commit(depth);
+            if (on_generation_)
+                on_generation_(*this);
+            metrics::publish(stats_.generation);
+        }
+
+        /**
+         * Performs @param generations steps, in blocks of WorldConfig::temporal_depth generations while possible.
+         * @see step_blocked()
+         */
+        void run(Index generations) {
+            const Index depth = config_.temporal_depth;
+            for (; generations >= depth && depth > 1; generations -= depth)
+                step_blocked(depth);
+            for (; generations != 0; -- generations)
+                step();
+        }
+
+        /// Counters of the current generation.
+        const GenerationStats &stats() const { return stats_; }
+
+        /// Block populations of the current generation. Without WorldConfig::pyramid_block it has no levels.
+        const PopulationPyramid &pyramid() const { return pyramid_; }
+
+        /**
+         * Population of the blocks of pyramid @param level covering the cells of @param area.
+         * Costs time proportional to the number of returned blocks.
+         * @throw errors::PYRAMID_OUT_OF_RANGE on a missing level, e.g. without WorldConfig::pyramid_block
+         */
+        Viewport viewport(const BoundingBox &area, Index level) const {
+            return pyramid_.viewport(area, level);
+        }
+
+        /// Installs a callback invoked after every generation. Pass an empty callback to remove it.
+        void on_generation(Callback callback) {
+            on_generation_ = std::move(callback);
+        }
+
+        Index tile_rows() const { return tile_rows_; }
+
+        Index tile_cols() const { return tile_cols_; }
+
+        /// Number of tiles. Tiles are numbered row by row.
+        Index tile_count() const { return tiles_.size(); }
+
+        /// Cells covered by @param tile.
+        BoundingBox tile_rect(Index tile) const {
+            if (tile >= tiles_.size())
+                throw errors::WORLD_OUT_OF_RANGE();
+            Index top = (tile / tile_cols_) * config_.tile_height;
+            Index left = (tile % tile_cols_) * config_.tile_width;
+            return BoundingBox{
+                top,
+                left,
+                std::min(top + config_.tile_height, height_),
+                std::min(left + config_.tile_width, width_)
+            };
+        }
+
+        /// Counters of @param tile for the current generation.
+        const TileStats &tile_stats(Index tile) const {
+            if (tile >= tiles_.size())
+                throw errors::WORLD_OUT_OF_RANGE();
+            return tiles_[tile];
+        }
+    };
+}
+
+#endif //CPP_GAME_OF_DEATH_WORLD_HPP
@@ -0,0 +1,361 @@
+#ifndef CPP_GAME_OF_DEATH_WORLD3D_HPP
+#define CPP_GAME_OF_DEATH_WORLD3D_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+#include "logger/metrics.hpp"
+#include "topology/conway_node.hpp"
+#include "topology/lattice.hpp"
+#include "buffer.hpp"
+#include "cell_view.hpp"
+#include "random.hpp"
+#include "rule.hpp"
+#include "stencil.hpp"
+#include "thread_pool.hpp"
+
+namespace engine::errors {
+    struct WORLD3D_OUT_OF_RANGE : public std::out_of_range {
+        WORLD3D_OUT_OF_RANGE() : std::out_of_range("World3D cell index is out of range") {};
+    };
+
+    struct WORLD3D_BAD_CONFIG : public std::invalid_argument {
+        WORLD3D_BAD_CONFIG() : std::invalid_argument("World3D size must be positive") {};
+    };
+}
+
+namespace engine {
+    using conway::CellState;
+    using topology::lattice::LatticeNeighborhood;
+
+    /**
+     * Flat-buffer engine for binary 3D automata with Life-like rules.
+     *
+     * Same semantic as stepping a topology::lattice::make_lattice() of nodes applying the LifeRule. Cells are stored
+     * one byte each, layer by layer, with a one-cell halo around the whole volume: it stays dead for RAW, copies the
+     * opposite border for TORUS and the border itself for REFLECT, so the kernel has no boundary checks.
+     *
+     * The 26-neighbor sum is separable: row sums of 3 cells, then plane sums of 3 row sums, then 3 plane sums give the
+     * 3x3x3 box (about 6 additions per cell instead of 26); the 18-neighbor sum also subtracts the 8 vertex neighbors,
+     * summed the same way. Layers are split between the workers, each keeping a rolling window of 3 plane sums.
+     */
+    class World3D {
+        Index width_;
+        Index height_;
+        Index depth_;
+        Index padded_width_;
+        Index padded_height_;
+        Index plane_;
+        GridTopology topology_;
+        LatticeNeighborhood neighborhood_;
+        LifeRule rule_;
+        /// Next state by `alive * 32 + count`.
+        std::array<std::uint8_t, 64> table_{};
+
+        CellBuffer current_;
+        CellBuffer next_;
+
+        /// Per-worker partial sums: row sums of one plane, then rolling windows of plane sums.
+        struct Scratch {
+            std::vector<std::uint8_t> rows;
+            std::vector<std::uint8_t> vertex_rows;
+            std::array<std::vector<std::uint8_t>, 3> boxes;
+            std::array<std::vector<std::uint8_t>, 3> vertices;
+        };
+
+        std::unique_ptr<ThreadPool> pool_;
+        std::vector<Scratch> scratch_;
+        std::vector<Index> slab_population_;
+        Index population_{};
+        Index generation_{};
+
+        Index offset_of(Index i, Index j, Index k) const {
+            return (j + 1) + (i + 1) * padded_width_ + (k + 1) * plane_;
+        }
+
+        /// First layer of @param slab, in padded coordinates.
+        Index slab_begin(Index slab) const {
+            return 1 + depth_ * slab / slab_population_.size();
+        }
+
+        /**
+         * Fills the halo: the opposite borders for TORUS, the borders themselves for REFLECT.
+         * Edges and corners follow, as rows and planes are copied whole.
+         */
+        void fill_halo() {
+            const bool torus = topology_ == GridTopology::TORUS;
+            std::uint8_t *cells = current_.data();
+            for (Index k = 1; k <= depth_; ++ k) {
+                for (Index i = 1; i <= height_; ++ i) {
+                    std::uint8_t *row = cells + k * plane_ + i * padded_width_;
+                    row[0] = torus ? row[width_] : row[1];
+                    row[width_ + 1] = torus ? row[1] : row[width_];
+                }
+                std::uint8_t *layer = cells + k * plane_;
+                std::uint8_t *below = layer + (height_ + 1) * padded_width_;
+                std::copy_n(layer + (torus ? height_ : 1) * padded_width_, padded_width_, layer);
+                std::copy_n(layer + (torus ? 1 : height_) * padded_width_, padded_width_, below);
+            }
+            std::copy_n(cells + (torus ? depth_ : 1) * plane_, plane_, cells);
+            std::copy_n(cells + (torus ? 1 : depth_) * plane_, plane_, cells + (depth_ + 1) * plane_);
+        }
+
+        /**
+         * Plane sums of padded layer @param k: every interior cell gets the sum of its 3x3 square within the layer
+         * (into @param box) and, if needed, of the 4 corners of the square (into @param vertex).
+         */
+        void plane_sums(Index k, Scratch &scratch, std::uint8_t *box, std::uint8_t *vertex) const {
+            const std::uint8_t *layer = current_.data() + k * plane_;
+            const bool edges = neighborhood_ == LatticeNeighborhood::EDGES;
+            for (Index i = 0; i != padded_height_; ++ i) {
+                const std::uint8_t *c = layer + i * padded_width_;
+                std::uint8_t *rows = scratch.rows.data() + i * padded_width_;
+                for (Index j = 1; j <= width_; ++ j)
+                    rows[j] = c[j - 1] + c[j] + c[j + 1];
+                if (edges) {
+                    std::uint8_t *vertex_rows = scratch.vertex_rows.data() + i * padded_width_;
+                    for (Index j = 1; j <= width_; ++ j)
+                        vertex_rows[j] = c[j - 1] + c[j + 1];
+                }
+            }
+            for (Index i = 1; i <= height_; ++ i) {
+                const std::uint8_t *up = scratch.rows.data() + (i - 1) * padded_width_;
+                const std::uint8_t *mid = scratch.rows.data() + i * padded_width_;
+                const std::uint8_t *down = scratch.rows.data() + (i + 1) * padded_width_;
+                std::uint8_t *out = box + i * padded_width_;
+                for (Index j = 1; j <= width_; ++ j)
+                    out[j] = up[j] + mid[j] + down[j];
+                if (edges) {
+                    const std::uint8_t *vertex_up = scratch.vertex_rows.data() + (i - 1) * padded_width_;
+                    const std::uint8_t *vertex_down = scratch.vertex_rows.data() + (i + 1) * padded_width_;
+                    std::uint8_t *vertex_out = vertex + i * padded_width_;
+                    for (Index j = 1; j <= width_; ++ j)
+                        vertex_out[j] = vertex_up[j] + vertex_down[j];
+                }
+            }
+        }
+
+        /// Steps padded layers [@param k0, @param k1) with separable sums. @return alive cells of the new layers
+        template<bool Edges>
+        Index exec_slab_separable(Index k0, Index k1, Scratch &scratch) {
+            auto window = [&](Index k) -> Index { return k % 3; };
+            for (Index k = k0 - 1; k != k0 + 1; ++ k)
+                plane_sums(k, scratch, scratch.boxes[window(k)].data(), scratch.vertices[window(k)].data());
+
+            Index population = 0;
+            for (Index k = k0; k != k1; ++ k) {
+                plane_sums(k + 1, scratch, scratch.boxes[window(k + 1)].data(), scratch.vertices[window(k + 1)].data());
+                const std::uint8_t *below = scratch.boxes[window(k - 1)].data();
+                const std::uint8_t *here = scratch.boxes[window(k)].data();
+                const std::uint8_t *above = scratch.boxes[window(k + 1)].data();
+                const std::uint8_t *vertex_below = scratch.vertices[window(k - 1)].data();
+                const std::uint8_t *vertex_above = scratch.vertices[window(k + 1)].data();
+                for (Index i = 1; i <= height_; ++ i) {
+                    Index row = i * padded_width_;
+                    const std::uint8_t *self = current_.data() + k * plane_ + row;
+                    std::uint8_t *out = next_.data() + k * plane_ + row;
+                    Index alive = 0;
+                    for (Index j = 1; j <= width_; ++ j) {
+                        unsigned count = below[row + j] + here[row + j] + above[row + j] - self[j];
+                        if constexpr (Edges)
+                            count -= vertex_below[row + j] + vertex_above[row + j];
+                        out[j] = table_[self[j] * 32 + count];
+                        alive += out[j];
+                    }
+                    population += alive;
+                }
+            }
+            return population;
+        }
+
+        /// Steps padded layers [@param k0, @param k1) summing the 6 face neighbors directly.
+        Index exec_slab_faces(Index k0, Index k1) {
+            Index population = 0;
+            for (Index k = k0; k != k1; ++ k)
+                for (Index i = 1; i <= height_; ++ i) {
+                    const std::uint8_t *c = current_.data() + k * plane_ + i * padded_width_;
+                    std::uint8_t *out = next_.data() + k * plane_ + i * padded_width_;
+                    Index alive = 0;
+                    for (Index j = 1; j <= width_; ++ j) {
+                        unsigned count = c[j - 1] + c[j + 1] + c[j - padded_width_] + c[j + padded_width_] +
+                                         c[j - plane_] + c[j + plane_];
+                        out[j] = table_[c[j] * 32 + count];
+                        alive += out[j];
+                    }
+                    population += alive;
+                }
+            return population;
+        }
+
+    public:
+        /**
+         * @param width cells per row
+         * @param height rows per layer
+         * @param depth layers
+         * @param rule Life-like rule over the neighbor count
+         * @param topology the way border cells are connected, in all three directions
+         * @param neighborhood same meaning as for topology::lattice::make_lattice()
+         * @param threads workers stepping layers in parallel, including the calling thread
+         * @throw errors::WORLD3D_BAD_CONFIG on zero sizes
+         */
+        World3D(
+                Index width,
+                Index height,
+                Index depth,
+                LifeRule rule = LifeRule::bays_4555(),
+                GridTopology topology = GridTopology::RAW,
+                LatticeNeighborhood neighborhood = LatticeNeighborhood::VERTICES,
+                Index threads = 1
+        ) :
+            width_{width},
+            height_{height},
+            depth_{depth},
+            padded_width_{width + 2},
+            padded_height_{height + 2},
+            plane_{(width + 2) * (height + 2)},
+            topology_{topology},
+            neighborhood_{neighborhood},
+            rule_{rule}
+        {
+            if (width == 0 || height == 0 || depth == 0)
+                throw errors::WORLD3D_BAD_CONFIG();
+            metrics::ScopedTimer timer{metrics::Phase::GRID_BUILD};
+            for (unsigned count = 0; count != 32; ++ count) {
+                table_[count] = rule_.next(0, count);
+                table_[32 + count] = rule_.next(1, count);
+            }
+
+            pool_ = std::make_unique<ThreadPool>(std::min(threads, depth));
+            slab_population_.assign(pool_->size(), 0);
+            scratch_.resize(pool_->size());
+            if (neighborhood_ != LatticeNeighborhood::FACES)
+                for (auto &scratch: scratch_) {
+                    scratch.rows.assign(plane_, 0);
+                    for (auto &box: scratch.boxes)
+                        box.assign(plane_, 0);
+                    if (neighborhood_ == LatticeNeighborhood::EDGES) {
+                        scratch.vertex_rows.assign(plane_, 0);
+                        for (auto &vertex: scratch.vertices)
+                            vertex.assign(plane_, 0);
+                    }
+                }
+
+            // First touch: each worker zeroes the layers it steps; the halo layers go to the first and the last.
+            current_ = CellBuffer{plane_ * (depth_ + 2)};
+            next_ = CellBuffer{plane_ * (depth_ + 2)};
+            pool_->run(slab_population_.size(), [this](Index slab, Index) {
+                Index first = slab == 0 ? 0 : slab_begin(slab);
+                Index last = slab + 1 == slab_population_.size() ? depth_ + 2 : slab_begin(slab + 1);
+                std::fill(current_.data() + first * plane_, current_.data() + last * plane_, 0);
+                std::fill(next_.data() + first * plane_, next_.data() + last * plane_, 0);
+            });
+        }
+
+        Index width() const { return width_; }
+
+        Index height() const { return height_; }
+
+        Index depth() const { return depth_; }
+
+        GridTopology topology() const { return topology_; }
+
+        LatticeNeighborhood neighborhood() const { return neighborhood_; }
+
+        const LifeRule &rule() const { return rule_; }
+
+        /// Number of generations performed.
+        Index generation() const { return generation_; }
+
+        /// Alive cells of the current generation.
+        Index population() const { return population_; }
+
+        CellState get(Index i, Index j, Index k) const {
+            if (i >= height_ || j >= width_ || k >= depth_)
+                throw errors::WORLD3D_OUT_OF_RANGE();
+            return current_[offset_of(i, j, k)] ? CellState::ALIVE : CellState::DEAD;
+        }
+
+        /**
+         * Current generation in place, indexed [k, i, j] so rows are contiguous; the halo is outside the view.
+         * Valid until the next step.
+         */
+        CellView<3> view() const {
+            return make_cell_view<3>(
+                current_.data() + offset_of(0, 0, 0), {depth_, height_, width_}, {plane_, padded_width_, 1}
+            );
+        }
+
+        /// Sets a cell of the current generation. Keeps the population exact.
+        void set(Index i, Index j, Index k, CellState state) {
+            if (i >= height_ || j >= width_ || k >= depth_)
+                throw errors::WORLD3D_OUT_OF_RANGE();
+            auto &cell = current_[offset_of(i, j, k)];
+            auto value = static_cast<std::uint8_t>(state == CellState::ALIVE);
+            population_ += value;
+            population_ -= cell;
+            cell = value;
+        }
+
+        /**
+         * Replaces every cell with a random soup: a cell is alive with probability @param density. Cell (i, j, k)
+         * is drawn from (@param seed, j + i * width() + k * width() * height()) alone, so the soup doesn't depend on
+         * the number of threads. Layers are filled in parallel.
+         * @throw errors::RANDOM_BAD_DENSITY if @param density is not within [0, 1]
+         */
+        void randomize(double density, std::uint64_t seed) {
+            const random::Density probability{density};
+            metrics::ScopedTimer timer{metrics::Phase::GRID_BUILD};
+            pool_->run(slab_population_.size(), [this, &probability, seed](Index slab, Index) {
+                Index population = 0;
+                for (Index k = slab_begin(slab) - 1; k != slab_begin(slab + 1) - 1; ++ k)
+                    for (Index i = 0; i != height_; ++ i) {
+                        std::uint8_t *row = current_.data() + offset_of(i, 0, k);
+                        Index first = (i + k * height_) * width_;
+                        for (Index j = 0; j != width_; ++ j) {
+                            row[j] = random::cell_alive(seed, first + j, probability);
+                            population += row[j];
+                        }
+                    }
+                slab_population_[slab] = population;
+            });
+            population_ = std::accumulate(slab_population_.begin(), slab_population_.end(), Index{0});
+        }
+
+        /// Advances the world by one generation.
+        void step() {
+            if (topology_ != GridTopology::RAW)
+                fill_halo();
+            pool_->run(slab_population_.size(), [this](Index slab, Index worker) {
+                metrics::ScopedTimer timer{metrics::Phase::EXEC};
+                Index k0 = slab_begin(slab);
+                Index k1 = slab_begin(slab + 1);
+                if (neighborhood_ == LatticeNeighborhood::FACES)
+                    slab_population_[slab] = exec_slab_faces(k0, k1);
+                else if (neighborhood_ == LatticeNeighborhood::EDGES)
+                    slab_population_[slab] = exec_slab_separable<true>(k0, k1, scratch_[worker]);
+                else
+                    slab_population_[slab] = exec_slab_separable<false>(k0, k1, scratch_[worker]);
+            });
+            {
+                metrics::ScopedTimer timer{metrics::Phase::COMMIT};
+                current_.swap(next_);
+                population_ = std::accumulate(slab_population_.begin(), slab_population_.end(), Index{0});
+                ++ generation_;
+            }
+            metrics::publish(generation_);
+        }
+
+        /// Performs @param generations steps.
+        void run(Index generations) {
+            for (; generations != 0; -- generations)
+                step();
+        }
+    };
+}
+
+#endif //CPP_GAME_OF_DEATH_WORLD3D_HPP
@@ -1,4 +1,30 @@
+#include <algorithm>
+
 #include "logger.hpp"
+#include "metrics.hpp"
+
+// ---------------------------------------------------- MessagePool ----------------------------------------------------
+
+namespace {
+    thread_local std::vector<std::string> message_buffers;
+}
+
+std::string MessagePool::acquire() {
+    if (message_buffers.empty())
+        return {};
+    auto buffer = std::move(message_buffers.back());
+    message_buffers.pop_back();
+    buffer.clear();
+    return buffer;
+}
+
+void MessagePool::release(std::string && buffer) {
+    if (message_buffers.size() == MAX_BUFFERS or buffer.capacity() > MAX_CAPACITY)
+        return;
+    if (message_buffers.capacity() == 0)
+        message_buffers.reserve(MAX_BUFFERS);
+    message_buffers.push_back(std::move(buffer));
+}
 
 // ---------------------------------------------------- LogHandler -----------------------------------------------------
 
@@ -29,13 +55,23 @@ void Logger::add_handler(LogHandler * handler) {
 }
 
 void Logger::remove_handler(LogHandler * handler) {
-    std::remove(handlers.begin(), handlers.end(), handler);
+    handlers.erase(std::remove(handlers.begin(), handlers.end(), handler), handlers.end());
+}
+
+bool Logger::is_enabled_for(int level) const {
+    return level >= get_level();
+}
+
+void Logger::emit(LogRecord && record) {
+    emit(record);
 }
 
-void Logger::emit(LogRecord record) {
-    if (record.level < get_level())
+void Logger::emit(LogRecord & record) {
+    if (not is_enabled_for(record.level))
         return;
 
+    metrics::ScopedTimer timer{metrics::Phase::LOGGING};
+    metrics::count(metrics::Counter::LOG_RECORDS);
     for(auto * handler : handlers) {
         /*TODO: Break when handlers are sorted.*/
         if (record.level < handler->get_level())
@@ -54,32 +90,24 @@ LoggerLogLevelHelper Logger::log(int level) {
 // ------------------------------------------------ LoggerLogLevelHelper ----------------------------------------------------
 
 LoggerLogLevelHelper& LoggerLogLevelHelper::operator << (std::string && msg) {
-    this->operator << (
-            LogRecord {
-                    std::forward<std::string> (msg),
-                    log_level
-            }
-    );
+    LogRecord record {
+        std::move(msg),
+        log_level
+    };
+    origin->emit(record);
+    // The caller's buffer is recycled for the next formatted records.
+    MessagePool::release(std::move(record.message));
     return *this;
 }
 
 LoggerLogLevelHelper& LoggerLogLevelHelper::operator << (const char * msg) {
-    this->operator << (
-        LogRecord {
-            std::string (msg),
-            log_level
-        }
-    );
-    return *this;
+    return write(std::string_view{msg});
 }
 
 LoggerLogLevelHelper& LoggerLogLevelHelper::operator << (LogRecord && record) {
-    if (log_level != LOG_LEVEL_NOT_SET and record.level != log_level) {
-        auto proxy_record = LogRecord{record};
-        proxy_record.level = log_level;
-        origin->emit(proxy_record);
-    }
-    else
-        origin->emit(record);
+    // The record is ours: its level is overridden in place rather than on a copy.
+    if (log_level != LOG_LEVEL_NOT_SET)
+        record.level = log_level;
+    origin->emit(record);
     return *this;
 }
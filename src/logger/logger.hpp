@@ -1,7 +1,11 @@
 #ifndef CPP_GAME_OF_DEATH_LOGGER_HPP
 #define CPP_GAME_OF_DEATH_LOGGER_HPP
 
+#include <charconv>
 #include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 constexpr int LOG_LEVEL_NOT_SET = -1;
@@ -16,15 +20,53 @@ struct LogRecord {
     int level{LOG_LEVEL_NOT_SET};
 
     LogRecord() = default;
-    LogRecord(std::string && message, int level) : message{message}, level{level} {} ;
+    LogRecord(std::string && message, int level) : message{std::move(message)}, level{level} {} ;
     ~LogRecord() = default;
 
-    LogRecord(LogRecord& base) = default;
+    LogRecord(const LogRecord& base) = default;
     LogRecord(LogRecord&& base) = default;
+    LogRecord& operator = (const LogRecord& base) = default;
     LogRecord& operator = (LogRecord&& base) = default;
 };
 
 
+/// Per-thread recycled message buffers: once they have grown, formatting a record allocates nothing.
+struct MessagePool {
+    static constexpr std::size_t MAX_BUFFERS = 8;
+    static constexpr std::size_t MAX_CAPACITY = 64 * 1024; ///< Larger buffers are freed rather than kept.
+
+    /// Empty buffer, with the capacity it had when released.
+    static std::string acquire();
+    static void release(std::string && buffer);
+};
+
+/// Appends @param value to @param out: text as is, numbers through std::to_chars.
+inline void append_message(std::string & out, std::string_view value) {
+    out.append(value);
+}
+
+/// Without it, string literals would convert to bool rather than to std::string_view.
+inline void append_message(std::string & out, const char * value) {
+    out.append(value);
+}
+
+inline void append_message(std::string & out, char value) {
+    out.push_back(value);
+}
+
+inline void append_message(std::string & out, bool value) {
+    out.append(value ? "true" : "false");
+}
+
+template<typename T>
+    requires std::is_arithmetic_v<T>
+void append_message(std::string & out, T value) {
+    char digits[64];
+    auto result = std::to_chars(digits, digits + sizeof digits, value);
+    out.append(digits, result.ptr);
+}
+
+
 class LogHandler {
     int level_{LOG_LEVEL_NOT_SET};
 
@@ -56,7 +98,12 @@ public:
     void add_handler(LogHandler * handler);
     void remove_handler(LogHandler * handler);
 
-    void emit(LogRecord record);
+    /// Whether a record of @param level would reach the handlers at all.
+    bool is_enabled_for(int level) const;
+
+    /// Passes the @param record by reference to every handler of its level.
+    void emit(LogRecord & record);
+    void emit(LogRecord && record);
     LoggerLogLevelHelper log(int level = LOG_LEVEL_NOT_SET);
 };
 
@@ -69,6 +116,22 @@ struct LoggerLogLevelHelper {
     LoggerLogLevelHelper& operator << (std::string && msg);
     LoggerLogLevelHelper& operator << (const char * msg);
     LoggerLogLevelHelper& operator << (LogRecord && record);
+
+    /**
+     * Formats @param args one after the other into a pooled buffer and emits it, e.g.
+     * `debug.write("generation ", generation, " population ", population, '\n')`.
+     * Nothing is formatted when the level is disabled.
+     */
+    template<typename... Args>
+    LoggerLogLevelHelper& write(const Args &... args) {
+        if (!origin->is_enabled_for(log_level))
+            return *this;
+        LogRecord record{MessagePool::acquire(), log_level};
+        (append_message(record.message, args), ...);
+        origin->emit(record);
+        MessagePool::release(std::move(record.message));
+        return *this;
+    }
 };
 
 #endif //CPP_GAME_OF_DEATH_LOGGER_HPP
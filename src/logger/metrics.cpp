@@ -0,0 +1,138 @@
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <vector>
+
+#include "metrics.hpp"
+
+namespace metrics {
+
+    // ------------------------------------------------------ Names ------------------------------------------------------
+
+    const char *phase_name(Phase phase) {
+        switch (phase) {
+            case Phase::GRID_BUILD: return "grid_build";
+            case Phase::EXEC: return "exec";
+            case Phase::COMMIT: return "commit";
+            case Phase::REWIRE: return "rewire";
+            case Phase::LOGGING: return "logging";
+            case Phase::IO: return "io";
+            default: return "unknown";
+        }
+    }
+
+    const char *counter_name(Counter counter) {
+        switch (counter) {
+            case Counter::TILES: return "tiles";
+            case Counter::LOG_RECORDS: return "log_records";
+            case Counter::REWIRED_EDGES: return "rewired_edges";
+            default: return "unknown";
+        }
+    }
+
+    // ---------------------------------------------------- Registry -----------------------------------------------------
+
+    namespace {
+        /// Counters of one thread and their values at the previous collect().
+        struct Entry {
+            std::shared_ptr<ThreadCounters> counters;
+            std::array<std::uint64_t, PHASE_COUNT> seen_ns{};
+            std::array<std::uint64_t, PHASE_COUNT> seen_calls{};
+            std::array<std::uint64_t, COUNTER_COUNT> seen_counters{};
+        };
+
+        struct Registry {
+            std::mutex mutex;
+            std::vector<Entry> entries;
+        };
+
+        Registry &registry() {
+            static Registry instance;
+            return instance;
+        }
+
+        std::uint64_t take(const std::atomic<std::uint64_t> &value, std::uint64_t &seen) {
+            auto current = value.load(std::memory_order_relaxed);
+            auto delta = current - seen;
+            seen = current;
+            return delta;
+        }
+    }
+
+    ThreadCounters &local_counters() {
+        // The registry shares ownership, so counters of finished threads are still collected once.
+        thread_local std::shared_ptr<ThreadCounters> counters = [] {
+            auto created = std::make_shared<ThreadCounters>();
+            auto &reg = registry();
+            std::lock_guard lock{reg.mutex};
+            reg.entries.push_back(Entry{created});
+            return created;
+        }();
+        return *counters;
+    }
+
+    GenerationMetrics collect(std::uint64_t generation) {
+        GenerationMetrics result;
+        result.generation = generation;
+        auto exec = static_cast<std::size_t>(Phase::EXEC);
+
+        auto &reg = registry();
+        std::lock_guard lock{reg.mutex};
+        for (auto &entry: reg.entries) {
+            for (std::size_t phase = 0; phase != PHASE_COUNT; ++ phase) {
+                auto ns = take(entry.counters->phase_ns[phase], entry.seen_ns[phase]);
+                result.phase_ns[phase] += ns;
+                result.phase_calls[phase] += take(entry.counters->phase_calls[phase], entry.seen_calls[phase]);
+                if (phase != exec || ns == 0)
+                    continue;
+                result.exec_min_ns = result.exec_threads == 0 ? ns : std::min(result.exec_min_ns, ns);
+                result.exec_max_ns = std::max(result.exec_max_ns, ns);
+                ++ result.exec_threads;
+            }
+            for (std::size_t counter = 0; counter != COUNTER_COUNT; ++ counter)
+                result.counters[counter] += take(entry.counters->counters[counter], entry.seen_counters[counter]);
+        }
+        // Everything of the finished threads is collected now.
+        std::erase_if(reg.entries, [](const Entry &entry) { return entry.counters.use_count() == 1; });
+        return result;
+    }
+
+    // ------------------------------------------------ GenerationMetrics ------------------------------------------------
+
+    double GenerationMetrics::exec_imbalance() const {
+        auto total = ns(Phase::EXEC);
+        if (exec_threads == 0 || total == 0)
+            return 1.0;
+        return static_cast<double>(exec_max_ns) * static_cast<double>(exec_threads) / static_cast<double>(total);
+    }
+
+    std::string GenerationMetrics::to_logfmt() const {
+        std::ostringstream line;
+        line << "generation=" << generation;
+        for (std::size_t phase = 0; phase != PHASE_COUNT; ++ phase) {
+            auto name = phase_name(static_cast<Phase>(phase));
+            line << ' ' << name << "_ns=" << phase_ns[phase] << ' ' << name << "_calls=" << phase_calls[phase];
+        }
+        for (std::size_t counter = 0; counter != COUNTER_COUNT; ++ counter)
+            line << ' ' << counter_name(static_cast<Counter>(counter)) << '=' << counters[counter];
+        line << " exec_threads=" << exec_threads
+             << " exec_max_ns=" << exec_max_ns
+             << " exec_min_ns=" << exec_min_ns
+             << " exec_imbalance=" << exec_imbalance()
+             << '\n';
+        return line.str();
+    }
+
+    // ------------------------------------------------- MetricsLogHandler -----------------------------------------------
+
+    Logger &metrics_logger() {
+        static Logger logger{LOG_LEVEL_DEBUG};
+        return logger;
+    }
+
+    void MetricsLogHandler::emit(LogRecord &record) {
+        ScopedTimer timer{Phase::IO};
+        stream_ << record.message;
+    }
+}
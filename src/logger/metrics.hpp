@@ -0,0 +1,161 @@
+#ifndef CPP_GAME_OF_DEATH_METRICS_HPP
+#define CPP_GAME_OF_DEATH_METRICS_HPP
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+#include "logger.hpp"
+
+/**
+ * Hot-path instrumentation: scoped phase timers and counters kept per thread,
+ * aggregated per generation and published through metrics_logger().
+ *
+ * The counters are process-wide, not per engine: a collection takes the time every thread spent in each phase,
+ * whichever engine it worked for. Engines stepping concurrently in one process therefore share their figures, and
+ * only one of them should collect or publish.
+ *
+ * Building without GAME_OF_DEATH_METRICS turns timers and counters into empty inline code.
+ */
+namespace metrics {
+
+#ifdef GAME_OF_DEATH_METRICS
+    constexpr bool ENABLED = true;
+#else
+    constexpr bool ENABLED = false;
+#endif
+
+    /// Measured phases. Phases may nest (e.g. IO inside LOGGING), so their times are not additive.
+    enum class Phase {
+        GRID_BUILD, ///< Building node grids and engine buffers.
+        EXEC, ///< Computing the next generation.
+        COMMIT, ///< Publishing the next generation.
+        REWIRE, ///< Applying staged topology changes.
+        LOGGING, ///< Dispatching log records to handlers.
+        IO, ///< Reading and writing streams and files.
+        COUNT_
+    };
+
+    /// Event counters.
+    enum class Counter {
+        TILES, ///< Tiles stepped.
+        LOG_RECORDS, ///< Records dispatched to handlers.
+        REWIRED_EDGES, ///< Neighbor links added or removed by staged rewiring.
+        COUNT_
+    };
+
+    constexpr std::size_t PHASE_COUNT = static_cast<std::size_t>(Phase::COUNT_);
+    constexpr std::size_t COUNTER_COUNT = static_cast<std::size_t>(Counter::COUNT_);
+
+    const char *phase_name(Phase phase);
+    const char *counter_name(Counter counter);
+
+    /// Counters of one thread. Written by the owning thread only, read by collect().
+    struct ThreadCounters {
+        std::array<std::atomic<std::uint64_t>, PHASE_COUNT> phase_ns{};
+        std::array<std::atomic<std::uint64_t>, PHASE_COUNT> phase_calls{};
+        std::array<std::atomic<std::uint64_t>, COUNTER_COUNT> counters{};
+    };
+
+    /// Counters of the calling thread, registered for collection on first use.
+    ThreadCounters &local_counters();
+
+    /// Single-writer increment: cheaper than an atomic read-modify-write.
+    inline void bump(std::atomic<std::uint64_t> &value, std::uint64_t delta) {
+        value.store(value.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+    }
+
+    /// Adds @param delta to the calling thread's @param counter.
+    inline void count(Counter counter, std::uint64_t delta = 1) {
+        if constexpr (ENABLED)
+            bump(local_counters().counters[static_cast<std::size_t>(counter)], delta);
+    }
+
+    /// Accumulates the lifetime of the object to the calling thread's @param phase.
+    class ScopedTimer {
+#ifdef GAME_OF_DEATH_METRICS
+        Phase phase_;
+        std::chrono::steady_clock::time_point start_;
+
+    public:
+        explicit ScopedTimer(Phase phase) : phase_{phase}, start_{std::chrono::steady_clock::now()} {};
+
+        ~ScopedTimer() {
+            auto elapsed = std::chrono::steady_clock::now() - start_;
+            auto &counters = local_counters();
+            auto idx = static_cast<std::size_t>(phase_);
+            bump(counters.phase_ns[idx], std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+            bump(counters.phase_calls[idx], 1);
+        }
+#else
+    public:
+        explicit constexpr ScopedTimer(Phase) {};
+#endif
+        ScopedTimer(const ScopedTimer &) = delete;
+        ScopedTimer &operator = (const ScopedTimer &) = delete;
+    };
+
+    /// Everything measured since the previous collect(), summed over all threads.
+    struct GenerationMetrics {
+        std::uint64_t generation{};
+        std::array<std::uint64_t, PHASE_COUNT> phase_ns{};
+        std::array<std::uint64_t, PHASE_COUNT> phase_calls{};
+        std::array<std::uint64_t, COUNTER_COUNT> counters{};
+        std::uint64_t exec_threads{}; ///< Threads which spent time in Phase::EXEC.
+        std::uint64_t exec_max_ns{}; ///< EXEC time of the slowest thread.
+        std::uint64_t exec_min_ns{}; ///< EXEC time of the fastest thread.
+
+        std::uint64_t ns(Phase phase) const { return phase_ns[static_cast<std::size_t>(phase)]; }
+
+        std::uint64_t calls(Phase phase) const { return phase_calls[static_cast<std::size_t>(phase)]; }
+
+        std::uint64_t count(Counter counter) const { return counters[static_cast<std::size_t>(counter)]; }
+
+        /// Slowest thread EXEC time over the mean one. 1.0 is a perfect balance.
+        double exec_imbalance() const;
+
+        /// Single line of `key=value` pairs.
+        std::string to_logfmt() const;
+    };
+
+    /**
+     * Collects and resets the counters of all threads of the process, including those working for other engines.
+     * Only one engine may collect at a time: concurrent callers split each other's measurements between them.
+     */
+    GenerationMetrics collect(std::uint64_t generation);
+
+    /// Logger receiving a record per published generation. Has no handlers by default.
+    Logger &metrics_logger();
+
+    /**
+     * Collects metrics of @param generation and emits them through metrics_logger() if it has handlers.
+     * Same restriction as collect(): a single engine of the process publishes.
+     */
+    inline void publish(std::uint64_t generation) {
+        if constexpr (ENABLED) {
+            auto &logger = metrics_logger();
+            if (logger.handlers.empty())
+                return;
+            logger.log(LOG_LEVEL_INFO) << collect(generation).to_logfmt();
+        }
+    }
+
+    /// Writes each structured record as a line to the given stream.
+    class MetricsLogHandler : public LogHandler {
+        std::ostream &stream_;
+
+    public:
+        explicit MetricsLogHandler(std::ostream &stream, int level = LOG_LEVEL_NOT_SET) :
+            LogHandler(level),
+            stream_{stream} {};
+
+        ~MetricsLogHandler() override = default;
+
+        void emit(LogRecord &record) override;
+    };
+}
+
+#endif //CPP_GAME_OF_DEATH_METRICS_HPP
@@ -4,6 +4,7 @@
 #include <array>
 #include <cassert>
 #include <iostream>
+#include <string>
 
 #include "logger/logger.hpp"
 
@@ -16,6 +17,12 @@ void test_LogRecord() {
     LogRecord rec_03{LogRecord{"also test message", LOG_LEVEL_WARNING}};
     assert(rec_03.message == "also test message");
     assert(rec_03.level == LOG_LEVEL_WARNING);
+
+    // The message is moved in, not copied: a heap buffer keeps its address.
+    std::string long_message(100, 'x');
+    auto * buffer = long_message.data();
+    LogRecord rec_04{std::move(long_message), LOG_LEVEL_DEBUG};
+    assert(rec_04.message.data() == buffer);
 }
 
 class TestLogHandler_ : public LogHandler {
@@ -151,6 +158,44 @@ void test_LoggerLogLevelHelper(
         std::cout << "\tOK\n";
 }
 
+class AddressLogHandler_ : public LogHandler {
+public:
+    std::string last_message;
+    const char * last_buffer{nullptr};
+    int emitted{0};
+
+    AddressLogHandler_(int level) : LogHandler(level) {};
+    void emit(LogRecord& record) override {
+        last_message = record.message;
+        last_buffer = record.message.data();
+        ++ emitted;
+    }
+};
+
+void test_LoggerLogLevelHelper_write() {
+    Logger logger{LOG_LEVEL_INFO};
+    AddressLogHandler_ handler{LOG_LEVEL_DEBUG};
+    logger.add_handler(&handler);
+
+    auto info = logger.log(LOG_LEVEL_INFO);
+    info.write("generation ", 42, " population ", std::size_t{1234567}, " density ", 0.25, ' ', true, '\n');
+    assert(handler.last_message == "generation 42 population 1234567 density 0.25 true\n");
+
+    // The buffer is recycled: the next record of the thread is formatted in the same memory.
+    info.write("generation ", 43, " population ", std::size_t{1234568}, " and a suffix longer than the SSO buffer");
+    auto * buffer = handler.last_buffer;
+    info.write("generation ", 44, " population ", std::size_t{1234569}, " and a suffix longer than the SSO buffer");
+    assert(handler.last_buffer == buffer && handler.last_message.starts_with("generation 44 "));
+
+    // Records below the logger level are not even formatted.
+    logger.log(LOG_LEVEL_DEBUG).write("skipped ", 1);
+    assert(handler.emitted == 3);
+
+    // A record passed to a helper of another level is re-leveled in place.
+    info << LogRecord{"moved", LOG_LEVEL_ERROR};
+    assert(handler.last_message == "moved" && handler.emitted == 4);
+}
+
 void test_LoggerLogLevelHelper(bool print = true) {
     std::array <int, 3> levels {LOG_LEVEL_NOT_SET, LOG_LEVEL_DEBUG, LOG_LEVEL_WARNING};
     std::array <int, 3> modes {1, 2, 3};
@@ -0,0 +1,66 @@
+#ifndef CPP_GAME_OF_DEATH_TEST_METRICS_H
+#define CPP_GAME_OF_DEATH_TEST_METRICS_H
+
+#include <cassert>
+#include <sstream>
+#include <thread>
+
+#include "logger/metrics.hpp"
+
+void test_metrics_collect() {
+    using namespace metrics;
+    collect(0); // Drop everything measured before.
+
+    {
+        ScopedTimer timer{Phase::EXEC};
+        count(Counter::TILES, 3);
+    }
+    std::thread{[] {
+        ScopedTimer timer{Phase::EXEC};
+        count(Counter::TILES);
+    }}.join();
+
+    auto measured = collect(1);
+    assert(measured.generation == 1);
+    if constexpr (ENABLED) {
+        assert(measured.calls(Phase::EXEC) == 2);
+        assert(measured.count(Counter::TILES) == 4);
+        assert(measured.exec_min_ns <= measured.exec_max_ns);
+        assert(measured.exec_imbalance() >= 1.0);
+    } else {
+        assert(measured.calls(Phase::EXEC) == 0);
+        assert(measured.count(Counter::TILES) == 0);
+    }
+
+    // Counters are reset by collection, including the ones of the finished thread.
+    auto empty = collect(2);
+    assert(empty.calls(Phase::EXEC) == 0);
+    assert(empty.count(Counter::TILES) == 0);
+}
+
+void test_metrics_publish() {
+    using namespace metrics;
+    std::ostringstream sink;
+    MetricsLogHandler handler{sink};
+    metrics_logger().add_handler(&handler);
+
+    { ScopedTimer timer{Phase::COMMIT}; }
+    publish(7);
+    metrics_logger().remove_handler(&handler);
+
+    if constexpr (ENABLED) {
+        auto line = sink.str();
+        assert(line.starts_with("generation=7 "));
+        assert(line.find(" commit_calls=1 ") != std::string::npos);
+        assert(line.ends_with("\n"));
+    } else {
+        assert(sink.str().empty());
+    }
+}
+
+void test_metrics() {
+    test_metrics_collect();
+    test_metrics_publish();
+}
+
+#endif //CPP_GAME_OF_DEATH_TEST_METRICS_H
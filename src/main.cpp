@@ -2,6 +2,24 @@
 #include "topology/tests/test_grid.hpp"
 #include "topology/tests/test_conway.hpp"
 #include "logger/tests/test_logger.h"
+#include "logger/tests/test_metrics.h"
+#include "engine/tests/test_ensemble.hpp"
+#include "engine/tests/test_world.hpp"
+#include "engine/tests/test_generations.hpp"
+#include "engine/tests/test_light_cone.hpp"
+#include "engine/tests/test_out_of_core.hpp"
+#include "engine/tests/test_cell_view.hpp"
+#include "engine/tests/test_static_grid.hpp"
+#include "engine/tests/test_block_lut.hpp"
+#include "engine/tests/test_pipeline.hpp"
+#include "engine/tests/test_numa.hpp"
+#include "engine/tests/test_autotune.hpp"
+#include "engine/tests/test_buffer.hpp"
+#include "engine/tests/test_differential.hpp"
+#include "engine/tests/test_pyramid.hpp"
+#include "engine/tests/test_random.hpp"
+#include "engine/tests/test_edits.hpp"
+#include "engine/tests/test_world3d.hpp"
 
 int main() {
     test_node();
@@ -10,12 +28,36 @@ int main() {
     test_LogHandler();
     test_Logger(false);
     test_LoggerLogLevelHelper(false);
+    test_LoggerLogLevelHelper_write();
+    test_metrics();
 
     {
         using namespace topology::grid;
         test_grid(3, 3).perform_tests();
         test_grid(5, 3).perform_tests();
         test_grid(3, 5, GridTopology::TORUS).perform_tests();
+        test_grid(4, 3, GridTopology::REFLECT).perform_tests();
+        test_grid_rewiring(1);
+        test_grid_rewiring(3);
+        test_grid_stepper();
     }
+
+    test_ensemble();
+    test_world();
+    test_generations();
+    test_pipeline();
+    test_numa();
+    test_buffer();
+    test_pyramid();
+    test_edits();
+    test_world3d();
+    test_random();
+    test_differential();
+    test_light_cone();
+    test_autotune();
+    test_out_of_core();
+    test_cell_view();
+    test_static_grid();
+    test_block_lut();
     return 0;
 }
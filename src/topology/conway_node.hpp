@@ -41,7 +41,7 @@ namespace conway {
     using ConwayNodeExecutorBase = NodeExecutor<CellState>;
 
 
-    class ConwayNodeExecutor : public ConwayNodeExecutorBase {
+    class ConwayNodeExecutor : public BatchNodeExecutor<ConwayNodeExecutor, CellState> {
 
         auto environment_state() try {
             std::function<CellState(ConwayNode *)> value_extractor = [](ConwayNode *node) -> CellState {
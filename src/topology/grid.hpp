@@ -1,11 +1,18 @@
 #ifndef CPP_GAME_OF_DEATH_GRID_HPP
 #define CPP_GAME_OF_DEATH_GRID_HPP
 
+#include <algorithm>
 #include <vector>
 #include <memory>
 #include <functional>
 #include <cassert>
+#include <cstddef>
+#include <numeric>
+#include <span>
+#include <typeindex>
+#include <unordered_map>
 
+#include "logger/metrics.hpp"
 #include "node.hpp"
 #include "node_array.hpp"
 
@@ -27,7 +34,14 @@ namespace topology::grid {
     /// Topology of the whole grid.
     enum class GridTopology {
         RAW, ///< Flat topology of the grid. Borders are not connected.
-        TORUS ///< Grid topology is folded so the opposite borders are glued, so the space enclosed.
+        TORUS, ///< Grid topology is folded so the opposite borders are glued, so the space enclosed.
+        REFLECT ///< Borders are mirrors: the neighbor beyond a border cell is the border cell itself.
+    };
+
+    /// Set of nodes each node of the grid is subscribed to.
+    enum class GridNeighborhood {
+        VON_NEUMANN, ///< Four orthogonal neighbors.
+        MOORE ///< Eight neighbors: orthogonal and diagonal.
     };
 
     /// Extract value type from specialized Node class
@@ -64,6 +78,13 @@ namespace topology::grid {
             return j + i * width;
         }
 
+        /// Folds @param coordinate into [0, @param size) by mirroring it at the borders: -1 -> 0, size -> size - 1.
+        constexpr std::ptrdiff_t reflect(std::ptrdiff_t coordinate, std::ptrdiff_t size) {
+            auto period = 2 * size;
+            coordinate = (coordinate % period + period) % period;
+            return coordinate < size ? coordinate : period - 1 - coordinate;
+        }
+
         /// If @param neighbor is not NULL adds it to the neighborhood of @param node
         template<typename TNode>
         void try_subscribe(TNode *node, TNode *neighbor) {
@@ -110,8 +131,14 @@ namespace topology::grid {
                         return nullptr;
                     return grid[ij_2_idx(i, j, width)];
                 case GridTopology::TORUS:
-                    j = j % width + (j < 0 && j % width != 0 ? width : 0);
-                    i = i % height + (i < 0 && i % height != 0 ? height : 0);
+                    // Index is unsigned, so `i - 1` at the border wraps around; adding the size folds it back.
+                    j = (j + width) % width;
+                    i = (i + height) % height;
+                    return grid[ij_2_idx(i, j, width)];
+                case GridTopology::REFLECT:
+                    // `i - 1` wraps around to -1 once signed again.
+                    i = reflect(static_cast<std::ptrdiff_t>(i), static_cast<std::ptrdiff_t>(height));
+                    j = reflect(static_cast<std::ptrdiff_t>(j), static_cast<std::ptrdiff_t>(width));
                     return grid[ij_2_idx(i, j, width)];
                 default:
                     throw errors::TOPOLOGY_NOT_IMPLEMENTED();
@@ -127,6 +154,7 @@ namespace topology::grid {
      * @param height grid actual height
      * @param executor_factory if NULL uses @tparam TExecutor() for each node, otherwise use @see t_executor_factory
      * @param topology the way border nodes are connected
+     * @param neighborhood which adjacent nodes each node is subscribed to
      * @return built Grid<TNode> object
      */
     template<typename TNode, typename TExecutor = executor_base_type<TNode>>
@@ -134,9 +162,11 @@ namespace topology::grid {
             Index width,
             Index height,
             t_executor_factory<TNode> * executor_factory = nullptr,  // TODO: make tests
-            GridTopology topology = GridTopology::RAW
+            GridTopology topology = GridTopology::RAW,
+            GridNeighborhood neighborhood = GridNeighborhood::VON_NEUMANN
     ) {
         using namespace topology::grid::assets;
+        metrics::ScopedTimer timer{metrics::Phase::GRID_BUILD};
 
         Index size = width * height;
         Grid<TNode> grid;
@@ -170,21 +200,208 @@ namespace topology::grid {
                 try_subscribe(node, get_node_if_exists(grid, i + 1, j, width, height, topology));
                 try_subscribe(node, get_node_if_exists(grid, i, j - 1, width, height, topology));
                 try_subscribe(node, get_node_if_exists(grid, i, j + 1, width, height, topology));
+                if (neighborhood == GridNeighborhood::MOORE) {
+                    try_subscribe(node, get_node_if_exists(grid, i - 1, j - 1, width, height, topology));
+                    try_subscribe(node, get_node_if_exists(grid, i - 1, j + 1, width, height, topology));
+                    try_subscribe(node, get_node_if_exists(grid, i + 1, j - 1, width, height, topology));
+                    try_subscribe(node, get_node_if_exists(grid, i + 1, j + 1, width, height, topology));
+                }
             }
         }
 
         return grid;
     }
 
+    /// Directed link: @param node has @param neighbor in its neighborhood.
+    template<typename TNode>
+    struct Edge {
+        TNode *node;
+        TNode *neighbor;
+    };
+
+    /**
+     * Proposes a batch of topology changes of @param grid, applied by the next commit_rewiring() (or step()).
+     * Nothing observable changes until then, so it is safe to call while executors iterate neighborhoods,
+     * but not concurrently with itself: the changes are kept by the grid, not by the nodes.
+     * @param added links to create
+     * @param removed links to remove, one link per entry
+     */
+    template<typename TNode>
+    void stage_rewiring(
+            Grid<TNode> &grid,
+            std::span<const Edge<TNode>> added,
+            std::span<const Edge<TNode>> removed
+    ) {
+        auto &links = grid.staged_links();
+        for (auto &edge: removed)
+            links.push_back({edge.node, edge.neighbor, false});
+        for (auto &edge: added)
+            links.push_back({edge.node, edge.neighbor, true});
+    }
+
+    /**
+     * Commits the staged links of @param grid grouped by node, from position @param first to @param last of the
+     * list. Both are moved forward to the start of a node's group, so that adjacent ranges share no node.
+     * @param scratch buffer of Neighborhood::commit()
+     * @return number of links added and removed
+     */
+    template<typename TNode>
+    Index commit_rewiring_range(Grid<TNode> &grid, Index first, Index last, std::vector<TNode *> &scratch) {
+        std::span links{grid.staged_links()};
+        auto group_start = [&links](Index at) {
+            while (at != 0 && at < links.size() && links[at].node == links[at - 1].node)
+                ++ at;
+            return at;
+        };
+        Index changed = 0;
+        for (Index begin = group_start(first), stop = group_start(last); begin < stop;) {
+            Index end = begin + 1;
+            while (end != links.size() && links[end].node == links[begin].node)
+                ++ end;
+            changed += links[begin].node->neighborhood()->commit(links.subspan(begin, end - begin), scratch);
+            begin = end;
+        }
+        return changed;
+    }
+
+    /// Orders the staged links of @param grid by node, keeping the staging order of each node's changes.
+    template<typename TNode>
+    void group_staged_links(Grid<TNode> &grid) {
+        std::ranges::stable_sort(grid.staged_links(), std::less<>{}, &Grid<TNode>::StagedLink::node);
+    }
+
+    /**
+     * Applies the staged changes of all the neighborhoods.
+     * Each neighborhood is rewritten once however many of its links change, and nodes without staged changes are not
+     * visited: when nothing was staged since the last commit, this returns at once.
+     * @return number of links added and removed
+     */
+    template<typename TNode>
+    Index commit_rewiring(Grid<TNode> &grid) {
+        if (!grid.rewiring_staged())
+            return 0;
+        metrics::ScopedTimer timer{metrics::Phase::REWIRE};
+        group_staged_links(grid);
+        auto &scratch = grid.rewiring_scratch();
+        if (scratch.empty())
+            scratch.resize(1);
+        Index changed = commit_rewiring_range(grid, 0, grid.staged_links().size(), scratch.front());
+        grid.staged_links().clear();
+        metrics::count(metrics::Counter::REWIRED_EDGES, changed);
+        return changed;
+    }
+
+    /**
+     * commit_rewiring() with the staged links split between the workers of @param pool, which is reused across
+     * generations.
+     * @tparam Pool provides `size()` and `run(tasks, job)` calling `job(task, worker)` for every task and waiting,
+     * as engine::ThreadPool does
+     */
+    template<typename TNode, typename Pool>
+    Index commit_rewiring(Grid<TNode> &grid, Pool &pool) {
+        if (!grid.rewiring_staged())
+            return 0;
+        metrics::ScopedTimer timer{metrics::Phase::REWIRE};
+        group_staged_links(grid);
+        const Index tasks = pool.size();
+        const Index links = grid.staged_links().size();
+        auto &scratch = grid.rewiring_scratch();
+        if (scratch.size() < tasks)
+            scratch.resize(tasks);
+        std::vector<Index> changed(tasks, 0);
+        pool.run(tasks, [&grid, &changed, &scratch, tasks, links](Index task, Index) {
+            const Index first = links * task / tasks;
+            const Index last = links * (task + 1) / tasks;
+            changed[task] = commit_rewiring_range(grid, first, last, scratch[task]);
+        });
+        grid.staged_links().clear();
+        Index total = std::accumulate(changed.begin(), changed.end(), Index{0});
+        metrics::count(metrics::Counter::REWIRED_EDGES, total);
+        return total;
+    }
+
+    /**
+     * Advances every node of the grid by one generation.
+     * All executors are run first, so each of them observes the current values and links only; then staged topology
+     * changes and staged values are committed.
+     * @param grid grid built by make_grid()
+     */
+    template<typename TNode>
+    void step(Grid<TNode> &grid) {
+        {
+            metrics::ScopedTimer timer{metrics::Phase::EXEC};
+            for (Index idx = 0; idx != grid.size(); ++ idx)
+                grid[idx]->executor()->exec();
+        }
+        commit_rewiring(grid);
+        metrics::ScopedTimer timer{metrics::Phase::COMMIT};
+        for (Index idx = 0; idx != grid.size(); ++ idx)
+            grid[idx]->value()->commit();
+    }
+
+    /**
+     * Steps a grid with executors grouped by their dynamic type.
+     * Groups are built once, so each generation makes one NodeExecutor::exec_batch() call per executor type instead
+     * of a virtual call per node in spatial order. As executors only stage values, the result is the same as step().
+     * Call regroup() after linking other executors to the grid's nodes.
+     * @tparam TNode
+     */
+    template<typename TNode>
+    class Stepper {
+        struct Group {
+            std::type_index type;
+            std::vector<TNode *> nodes;
+        };
+
+        Grid<TNode> &grid_;
+        std::vector<Group> groups_;
+
+    public:
+        explicit Stepper(Grid<TNode> &grid) : grid_{grid} {
+            regroup();
+        }
+
+        /// Rebuilds the groups from the current executors.
+        void regroup() {
+            metrics::ScopedTimer timer{metrics::Phase::GRID_BUILD};
+            groups_.clear();
+            std::unordered_map<std::type_index, Index> group_of;
+            for (Index idx = 0; idx != grid_.size(); ++ idx) {
+                std::type_index type{typeid(*grid_[idx]->executor())};
+                auto [found, inserted] = group_of.try_emplace(type, groups_.size());
+                if (inserted)
+                    groups_.push_back(Group{type, {}});
+                groups_[found->second].nodes.push_back(grid_[idx]);
+            }
+        }
+
+        /// Number of distinct executor types.
+        Index groups() const { return groups_.size(); }
+
+        /// Same as grid::step(), executing group by group.
+        void step() {
+            {
+                metrics::ScopedTimer timer{metrics::Phase::EXEC};
+                for (auto &group: groups_)
+                    group.nodes.front()->executor()->exec_batch(group.nodes);
+            }
+            commit_rewiring(grid_);
+            metrics::ScopedTimer timer{metrics::Phase::COMMIT};
+            for (Index idx = 0; idx != grid_.size(); ++ idx)
+                grid_[idx]->value()->commit();
+        }
+    };
+
     /// Alias for building Grid for given @tparam ValueType
     template<typename ValueType>
     Grid<Node<ValueType>> make_grid_v(
             Index width,
             Index height,
             t_executor_factory<Node<ValueType>> * executor_factory = nullptr,
-            GridTopology topology = GridTopology::RAW
+            GridTopology topology = GridTopology::RAW,
+            GridNeighborhood neighborhood = GridNeighborhood::VON_NEUMANN
     ) {
-        return make_grid<Node<ValueType>>(width, height, executor_factory, topology);
+        return make_grid<Node<ValueType>>(width, height, executor_factory, topology, neighborhood);
     }
 
 }
@@ -0,0 +1,138 @@
+#ifndef CPP_GAME_OF_DEATH_LATTICE_HPP
+#define CPP_GAME_OF_DEATH_LATTICE_HPP
+
+#include <array>
+#include <cassert>
+#include <cstddef>
+
+#include "logger/metrics.hpp"
+#include "grid.hpp"
+
+namespace topology::lattice {
+
+    using topology::Index;
+    using topology::grid::GridTopology;
+    using topology::grid::executor_base_type;
+
+    /// Lattice object is the same as @see NodeArray
+    template<typename TNode>
+    using Lattice = topology::NodeArray<TNode>;
+
+    /// Set of nodes each node of the lattice is subscribed to.
+    enum class LatticeNeighborhood {
+        FACES, ///< 6 neighbors sharing a face.
+        EDGES, ///< 18 neighbors sharing a face or an edge.
+        VERTICES ///< 26 neighbors sharing at least a vertex (3D Moore neighborhood).
+    };
+
+    /// Relative position of a lattice neighbor.
+    struct Offset3 {
+        int di; ///< Row shift.
+        int dj; ///< Column shift.
+        int dk; ///< Layer shift.
+    };
+
+    /// All 26 offsets: the 6 face neighbors first, then the 12 edge ones, then the 8 vertex ones.
+    constexpr std::array<Offset3, 26> LATTICE_OFFSETS = [] {
+        std::array<Offset3, 26> offsets{};
+        Index n = 0;
+        for (int shared = 1; shared <= 3; ++ shared)
+            for (int dk = -1; dk <= 1; ++ dk)
+                for (int di = -1; di <= 1; ++ di)
+                    for (int dj = -1; dj <= 1; ++ dj)
+                        if ((di != 0) + (dj != 0) + (dk != 0) == shared)
+                            offsets[n ++] = Offset3{di, dj, dk};
+        return offsets;
+    }();
+
+    /// Number of neighbors of the @param neighborhood.
+    constexpr Index neighbor_count(LatticeNeighborhood neighborhood) {
+        switch (neighborhood) {
+            case LatticeNeighborhood::FACES: return 6;
+            case LatticeNeighborhood::EDGES: return 18;
+            default: return 26;
+        }
+    }
+
+    /**
+     * Factory method of node's executors for make_lattice().
+     * The factory receives (i, j, k, height, width, depth): the node's row, column and layer, then the lattice size.
+     */
+    template<typename TNode>
+    using t_executor_factory = executor_base_type<TNode>*(Index, Index, Index, Index, Index, Index);
+
+    /**
+     * Assets namespace is not meant to be used from outside
+     */
+    namespace assets {
+        /// (i, j, k) -> linear index (node number): layer by layer, each layer row by row.
+        inline Index ijk_2_idx(Index i, Index j, Index k, Index width, Index height) {
+            return j + i * width + k * width * height;
+        }
+
+        /// Folds the shifted coordinate into [0, size) for TORUS and REFLECT. @return false if outside a RAW lattice
+        inline bool shift_coordinate(Index &coordinate, int shift, Index size, GridTopology topology) {
+            auto shifted = static_cast<std::ptrdiff_t>(coordinate) + shift;
+            auto extent = static_cast<std::ptrdiff_t>(size);
+            if (topology == GridTopology::TORUS)
+                shifted = (shifted % extent + extent) % extent;
+            else if (topology == GridTopology::REFLECT)
+                shifted = grid::assets::reflect(shifted, extent);
+            else if (shifted < 0 || shifted >= extent)
+                return false;
+            coordinate = static_cast<Index>(shifted);
+            return true;
+        }
+    }
+
+    /**
+     * Builds a 3D lattice of nodes: `depth` layers of `height` rows of `width` nodes.
+     * Same conventions as grid::make_grid(); neighbors are subscribed in the LATTICE_OFFSETS order.
+     * @tparam TNode
+     * @tparam TExecutor custom executor type, used when @param executor_factory is NULL
+     * @param topology the way border nodes are connected, in all three directions
+     * @param neighborhood which adjacent nodes each node is subscribed to
+     * @return built Lattice<TNode> object
+     */
+    template<typename TNode, typename TExecutor = executor_base_type<TNode>>
+    Lattice<TNode> make_lattice(
+            Index width,
+            Index height,
+            Index depth,
+            t_executor_factory<TNode> *executor_factory = nullptr,
+            GridTopology topology = GridTopology::RAW,
+            LatticeNeighborhood neighborhood = LatticeNeighborhood::VERTICES
+    ) {
+        using namespace topology::lattice::assets;
+        metrics::ScopedTimer timer{metrics::Phase::GRID_BUILD};
+
+        Lattice<TNode> lattice;
+        lattice.resize(width * height * depth);
+        for (Index k = 0; k != depth; ++ k)
+            for (Index i = 0; i != height; ++ i)
+                for (Index j = 0; j != width; ++ j)
+                    lattice[ijk_2_idx(i, j, k, width, height)] = grid::assets::make_node<TNode>(
+                        executor_factory ? executor_factory(i, j, k, height, width, depth) : new TExecutor{}
+                    );
+
+        const Index count = neighbor_count(neighborhood);
+        for (Index k = 0; k != depth; ++ k)
+            for (Index i = 0; i != height; ++ i)
+                for (Index j = 0; j != width; ++ j) {
+                    TNode *node = lattice[ijk_2_idx(i, j, k, width, height)];
+                    assert(node == node->executor()->node());
+                    for (Index n = 0; n != count; ++ n) {
+                        auto [di, dj, dk] = LATTICE_OFFSETS[n];
+                        Index ni = i, nj = j, nk = k;
+                        if (shift_coordinate(ni, di, height, topology) &&
+                            shift_coordinate(nj, dj, width, topology) &&
+                            shift_coordinate(nk, dk, depth, topology))
+                            node->neighborhood()->subscribe_to(lattice[ijk_2_idx(ni, nj, nk, width, height)]);
+                    }
+                }
+
+        return lattice;
+    }
+}
+
+#endif //CPP_GAME_OF_DEATH_LATTICE_HPP
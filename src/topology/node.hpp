@@ -2,12 +2,15 @@
 #define GAMEOFDEATH_NODE_HPP
 
 #include <algorithm>
+#include <functional>
 #include <vector>
 #include <iostream>
 #include <iterator>
 #include <optional>
+#include <span>
 #include <stdexcept>
 #include <string>
+#include <typeinfo>
 
 #include "logger/standard_logger.hpp"
 
@@ -74,7 +77,7 @@ namespace topology {
                 value_ = staged_value_.value();
                 staged_value_.reset();
                 if constexpr (std::is_same<decltype(value_), int>::value)
-                    debug << std::to_string(value_);
+                    debug.write(value_);
             }
         }
 
@@ -103,6 +106,16 @@ namespace topology {
         /// Overridable node's execution behavior.
         virtual void exec() {};
 
+        /**
+         * Executes a batch of nodes whose executors all have the same dynamic type as this one.
+         * The default makes a virtual exec() call per node; BatchNodeExecutor replaces it with a devirtualized loop.
+         * @param nodes nodes to execute, this executor's node doesn't have to be among them
+         */
+        virtual void exec_batch(std::span<Node_ *> nodes) {
+            for (auto *node: nodes)
+                node->executor()->exec();
+        }
+
         /// Linked node getter. Allows to access node's properties in `exec()` implementation.
         Node_ *node() const {
             if (node_ == nullptr)
@@ -119,6 +132,24 @@ namespace topology {
         }
     };
 
+    /**
+     * CRTP base of executors that run batches without a virtual call per node.
+     * Derive as `class MyExecutor : public BatchNodeExecutor<MyExecutor, ValueType>` and override `exec()` as usual.
+     * @tparam Derived the executor class itself; its `exec()` is called non-virtually for every node of a batch
+     * @tparam ValueType
+     */
+    template<typename Derived, typename ValueType>
+    class BatchNodeExecutor : public NodeExecutor<ValueType> {
+    public:
+        void exec_batch(std::span<Node<ValueType> *> nodes) override {
+            // A subclass of Derived may override exec() in turn: then only the virtual call is right.
+            if (typeid(*this) != typeid(Derived))
+                return NodeExecutor<ValueType>::exec_batch(nodes);
+            for (auto *node: nodes)
+                static_cast<Derived *>(node->executor())->Derived::exec();
+        }
+    };
+
     /**
      * Node's list neighbors delegate (bridged property).
      * Implements node's ability to have neighbors.
@@ -151,6 +182,45 @@ namespace topology {
             neighbors_.erase(found);
         }
 
+        /**
+         * Apply a batch of link changes: removals first, then additions in order.
+         * Neighborhoods are small, so all removals take a single pass over the neighbors, which keep their order, with
+         * each neighbor looked up linearly among the removals still pending. Removing a node which is not a neighbor
+         * does nothing.
+         * @param changes link changes, each with a `neighbor` and whether it is `added` (otherwise one link to it is
+         * removed), e.g. NodeArray::StagedLink
+         * @param scratch buffer reused across calls, so that a commit doesn't allocate once it has grown
+         * @return number of links added and removed
+         */
+        template<typename Changes>
+        std::size_t commit(const Changes &changes, NeighborArray &scratch) {
+            scratch.clear();
+            for (auto &change: changes)
+                if (!change.added)
+                    scratch.push_back(change.neighbor);
+            std::size_t changed = 0;
+            if (!scratch.empty()) {
+                auto before = neighbors_.size();
+                auto kept = std::remove_if(neighbors_.begin(), neighbors_.end(), [&scratch](TNode *node) {
+                    auto found = std::find(scratch.begin(), scratch.end(), node);
+                    if (found == scratch.end())
+                        return false;
+                    // Each staged removal unlinks one neighbor only.
+                    *found = scratch.back();
+                    scratch.pop_back();
+                    return true;
+                });
+                neighbors_.erase(kept, neighbors_.end());
+                changed = before - neighbors_.size();
+            }
+            for (auto &change: changes)
+                if (change.added) {
+                    neighbors_.push_back(change.neighbor);
+                    ++ changed;
+                }
+            return changed;
+        }
+
         /// Number of neighbors.
         const std::size_t size() const {
             return neighbors_.size();
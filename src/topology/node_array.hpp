@@ -1,6 +1,7 @@
 #ifndef CPP_GAME_OF_DEATH_NODE_ARRAY_HPP
 #define CPP_GAME_OF_DEATH_NODE_ARRAY_HPP
 
+#include <utility>
 #include <vector>
 
 namespace topology {
@@ -14,8 +15,35 @@ namespace topology {
      */
     template<typename TNode>
     class NodeArray {
+    public:
+        /// Change of the neighborhood of @param node staged by grid::stage_rewiring().
+        struct StagedLink {
+            TNode *node;
+            TNode *neighbor;
+            bool added; ///< Whether the link to @param neighbor is created, otherwise one such link is removed.
+        };
+
+    private:
         std::vector<TNode *> items_;
+        /// Staged changes of all the neighborhoods, so that nodes don't carry staging buffers of their own.
+        std::vector<StagedLink> staged_links_;
+        /// Per-worker scratch of Neighborhood::commit(), kept to reuse its memory.
+        std::vector<std::vector<TNode *>> rewiring_scratch_;
     public:
+        NodeArray() = default;
+
+        /// The array owns its nodes, so it can be moved but not copied.
+        NodeArray(const NodeArray &) = delete;
+        NodeArray &operator = (const NodeArray &) = delete;
+        NodeArray(NodeArray &&) noexcept = default;
+
+        NodeArray &operator = (NodeArray &&other) noexcept {
+            items_.swap(other.items_);
+            staged_links_.swap(other.staged_links_);
+            rewiring_scratch_.swap(other.rewiring_scratch_);
+            return *this;
+        }
+
         TNode* & operator[](Index idx) {
             return items_[idx];
         }
@@ -24,6 +52,25 @@ namespace topology {
             items_.resize(new_size);
         }
 
+        Index size() const {
+            return items_.size();
+        }
+
+        /// Whether neighborhoods of the nodes have staged changes, see grid::stage_rewiring().
+        bool rewiring_staged() const {
+            return !staged_links_.empty();
+        }
+
+        /// Staged neighborhood changes, in staging order until grid::commit_rewiring() groups them by node.
+        std::vector<StagedLink> &staged_links() {
+            return staged_links_;
+        }
+
+        /// Scratch buffers of grid::commit_rewiring(), one per worker.
+        std::vector<std::vector<TNode *>> &rewiring_scratch() {
+            return rewiring_scratch_;
+        }
+
         ~NodeArray() {
             for (auto *node: items_) delete node;
         }
@@ -2,9 +2,13 @@
 #define CPP_GAME_OF_DEATH_TEST_GRID_HPP
 #include <iostream>
 #include <memory>
+#include <algorithm>
 #include <cassert>
+#include <vector>
 
+#include "../conway_node.hpp"
 #include "../grid.hpp"
+#include "engine/thread_pool.hpp"
 
 using namespace topology;
 using namespace topology::grid;
@@ -15,7 +19,7 @@ struct test_grid {
     class NodeExecutorMock : public topology::grid::executor_base_type<TNode> {
         void exec() override {
             auto neighbor_count = node()->neighborhood()->size();
-            debug << " this node has " + std::to_string(neighbor_count) + " neighbors\n";
+            debug.write(" this node has ", neighbor_count, " neighbors\n");
             node()->value()->stage(int(neighbor_count));
             node()->value()->commit();
         }
@@ -42,7 +46,8 @@ struct test_grid {
                 bool is_corner = is_h_border && is_v_border;
 
                 ValueType expected_neighbor_count;
-                if (topology_ == GridTopology::TORUS)
+                // Wrapped and mirrored neighbors are subscribed even if it is the node itself.
+                if (topology_ != GridTopology::RAW)
                     expected_neighbor_count = 4;
                 else if (is_corner)
                     expected_neighbor_count = 2;
@@ -52,8 +57,8 @@ struct test_grid {
                     expected_neighbor_count = 4;
 
                 // Exec node and find real number of neighbors.
-                debug << ("[" + std::to_string(i) + ", " + std::to_string(j) + "]");
-                debug << " (expect " + std::to_string(expected_neighbor_count) + " neighbors)";
+                debug.write("[", i, ", ", j, "]");
+                debug.write(" (expect ", expected_neighbor_count, " neighbors)");
                 TNode * node = grid[ij_2_idx(i, j, width_)];
                 node->executor()->exec();
 
@@ -64,5 +69,76 @@ struct test_grid {
     }
 };
 
+/// Batched rewiring: every node drops its first neighbor and links to itself, committed by several threads.
+void test_grid_rewiring(Index threads) {
+    engine::ThreadPool pool{threads};
+    using TNode = Node<int>;
+    auto grid = make_grid<TNode>(7, 5, nullptr, GridTopology::TORUS, GridNeighborhood::MOORE);
+
+    std::vector<Edge<TNode>> added;
+    std::vector<Edge<TNode>> removed;
+    for (Index idx = 0; idx != grid.size(); ++ idx) {
+        removed.push_back({grid[idx], *grid[idx]->neighborhood()->begin()});
+        added.push_back({grid[idx], grid[idx]});
+    }
+    // Nothing staged yet: the grid is not scanned.
+    assert(commit_rewiring(grid, pool) == 0);
+    stage_rewiring<TNode>(grid, added, removed);
+    assert(grid.rewiring_staged() && grid[0]->neighborhood()->size() == 8);
+
+    assert(commit_rewiring(grid, pool) == 2 * grid.size());
+    assert(!grid.rewiring_staged() && grid.staged_links().empty() && commit_rewiring(grid) == 0);
+    for (Index idx = 0; idx != grid.size(); ++ idx) {
+        auto *neighborhood = grid[idx]->neighborhood();
+        assert(neighborhood->size() == 8);
+        assert(*(neighborhood->end() - 1) == grid[idx]);
+        assert(std::count(neighborhood->begin(), neighborhood->end(), removed[idx].neighbor) == 0);
+    }
+}
+
+/// Keeps its node's value.
+struct FrozenExecutor : public BatchNodeExecutor<FrozenExecutor, conway::CellState> {
+    void exec() override {
+        node()->value()->stage(node()->value()->get());
+    }
+};
+
+/// Same behavior as its base, but a distinct executor type.
+struct DerivedConwayExecutor : public conway::ConwayNodeExecutor {};
+
+executor_base_type<conway::ConwayNode> *make_mixed_executor(Index i, Index j, Index, Index) {
+    switch ((i + 2 * j) % 3) {
+        case 0: return new FrozenExecutor;
+        case 1: return new conway::ConwayNodeExecutor;
+        default: return new DerivedConwayExecutor;
+    }
+}
+
+/// Grouped batch execution must give the same generations as per-node step().
+void test_grid_stepper() {
+    using conway::CellState;
+    using conway::ConwayNode;
+
+    const Index width = 9;
+    const Index height = 7;
+    auto reference = make_grid<ConwayNode>(width, height, make_mixed_executor, GridTopology::TORUS, GridNeighborhood::MOORE);
+    auto grouped = make_grid<ConwayNode>(width, height, make_mixed_executor, GridTopology::TORUS, GridNeighborhood::MOORE);
+    for (Index idx = 0; idx != reference.size(); ++ idx) {
+        auto state = (idx * 7 + idx / 3) % 3 == 0 ? CellState::ALIVE : CellState::DEAD;
+        reference[idx]->value()->stage(state);
+        reference[idx]->value()->commit();
+        grouped[idx]->value()->stage(state);
+        grouped[idx]->value()->commit();
+    }
+
+    Stepper<ConwayNode> stepper{grouped};
+    assert(stepper.groups() == 3);
+    for (int generation = 0; generation != 4; ++ generation) {
+        step(reference);
+        stepper.step();
+        for (Index idx = 0; idx != reference.size(); ++ idx)
+            assert(reference[idx]->value()->get() == grouped[idx]->value()->get());
+    }
+}
 
 #endif //CPP_GAME_OF_DEATH_TEST_GRID_HPP
@@ -5,6 +5,7 @@
 #include "topology/conway_node.hpp"
 #include <stdexcept>
 #include <cassert>
+#include <vector>
 
 
 void test_node() {
@@ -56,6 +57,27 @@ void test_node() {
 
     node.neighborhood()->unsubscribe_from(&node);
     assert(node.neighborhood()->size() == 0);
+
+    // Test staged rewiring
+    Node_ first, second;
+    auto *neighborhood = node.neighborhood();
+    neighborhood->subscribe_to(&first);
+    neighborhood->subscribe_to(&second);
+    neighborhood->subscribe_to(&first);
+    struct Change {
+        Node_ *neighbor;
+        bool added;
+    };
+    const std::vector<Change> changes{{&first, false}, {&node, false}, {&node, true}};
+    std::vector<Node_ *> scratch;
+    assert(neighborhood->commit(changes, scratch) == 2);
+    std::vector<Node_ *> expected{&second, &first, &node};
+    assert(std::equal(neighborhood->begin(), neighborhood->end(), expected.begin(), expected.end()));
+
+    // Unsubscribing keeps the order of the other neighbors too.
+    neighborhood->unsubscribe_from(&second);
+    expected = {&first, &node};
+    assert(std::equal(neighborhood->begin(), neighborhood->end(), expected.begin(), expected.end()));
 }
 
 